@@ -0,0 +1,319 @@
+// Copyright 2023 binoll
+// AVLSearchTree add and remove of shuffled distinct keys, with int64_t and a
+// 128-byte record whose copies are not free, next to the value-swapping rotations
+// the tree used before; the sizes are checked after each phase.
+// usage: bench_avl [elements] [rounds]
+#include "../libs.hpp"
+#include "../data_structures/trees/avl.hpp"
+
+struct Record {
+    int64_t key = 0;
+    char payload[120] = {};  // moved by every rotation of SwappingAVL
+
+    Record() = default;
+
+    explicit Record(const int64_t& key) : key(key) {}
+
+    bool operator<(const Record& record) const { return key < record.key; }
+
+    bool operator>(const Record& record) const { return key > record.key; }
+
+    bool operator==(const Record& record) const { return key == record.key; }
+
+    bool operator!=(const Record& record) const { return key != record.key; }
+};
+
+// The rebalancing of AVLSearchTree before rotations relinked the nodes: a rotation
+// swaps the values of the subtree root and its child, so the root node keeps its
+// place, and remove copies the successor's value into the removed node. Nodes and
+// pool are the ones of AVLSearchTree, so only the moves of the values differ.
+template<typename type>
+class SwappingAVL {
+ public:
+    ~SwappingAVL();  // destructor
+
+    void add(const type& value);  // add element
+
+    void remove(const type& value);  // delete element
+
+    int64_t getSize() const;  // returns the current size of tree
+
+    bool isClear() const;  // checking for emptiness
+
+ private:
+    int64_t heightOf(const NodeIndex& node) const;
+
+    int64_t countOf(const NodeIndex& node) const;
+
+    void updateHeight(const NodeIndex& node);  // also updates the subtree size
+
+    int64_t getBalance(const NodeIndex& node) const;
+
+    void rightRotate(const NodeIndex& node);  // the values move, node stays the root of the subtree
+
+    void leftRotate(const NodeIndex& node);  // the values move, node stays the root of the subtree
+
+    void balance(const NodeIndex& node);
+
+    void retrace(NodeIndex* path, int64_t depth);  // fix heights bottom-up until one does not change
+
+    static constexpr int64_t max_height = 96;  // bound on the height of any AVL tree in memory
+
+    NodePool<Node<type>> pool;  // storage of the nodes
+    NodeIndex root = no_node;  // index of the root of the tree
+    int64_t size = 0;  // current size of the tree
+};
+
+template<typename type>
+SwappingAVL<type>::~SwappingAVL() {
+    std::vector<NodeIndex> stack;
+
+    if (root != no_node) {
+        stack.push_back(root);
+    }
+    while (!stack.empty()) {
+        NodeIndex node = stack.back();
+
+        stack.pop_back();
+        if (pool[node].left != no_node) {
+            stack.push_back(pool[node].left);
+        }
+        if (pool[node].right != no_node) {
+            stack.push_back(pool[node].right);
+        }
+        pool.deallocate(node);
+    }
+}
+
+template<typename type>
+int64_t SwappingAVL<type>::heightOf(const NodeIndex& node) const {
+    return (node == no_node) ? -1 : pool[node].height;
+}
+
+template<typename type>
+int64_t SwappingAVL<type>::countOf(const NodeIndex& node) const {
+    return (node == no_node) ? 0 : pool[node].count;
+}
+
+template<typename type>
+void SwappingAVL<type>::updateHeight(const NodeIndex& node) {
+    pool[node].height = static_cast<int8_t>(std::max(heightOf(pool[node].left), heightOf(pool[node].right)) + 1);
+    pool[node].count = static_cast<uint32_t>(countOf(pool[node].left) + countOf(pool[node].right) + 1);
+}
+
+template<typename type>
+int64_t SwappingAVL<type>::getBalance(const NodeIndex& node) const {
+    return heightOf(pool[node].right) - heightOf(pool[node].left);
+}
+
+template<typename type>
+void SwappingAVL<type>::rightRotate(const NodeIndex& node) {
+    NodeIndex left = pool[node].left;
+    NodeIndex right = pool[node].right;
+
+    std::swap(pool[node].value, pool[left].value);
+    pool[node].left = pool[left].left;
+    pool[left].left = pool[left].right;
+    pool[left].right = right;
+    pool[node].right = left;
+    updateHeight(left);
+    updateHeight(node);
+}
+
+template<typename type>
+void SwappingAVL<type>::leftRotate(const NodeIndex& node) {
+    NodeIndex left = pool[node].left;
+    NodeIndex right = pool[node].right;
+
+    std::swap(pool[node].value, pool[right].value);
+    pool[node].right = pool[right].right;
+    pool[right].right = pool[right].left;
+    pool[right].left = left;
+    pool[node].left = right;
+    updateHeight(right);
+    updateHeight(node);
+}
+
+template<typename type>
+void SwappingAVL<type>::balance(const NodeIndex& node) {
+    int64_t balance = getBalance(node);
+
+    if (balance == -2) {
+        if (getBalance(pool[node].left) == 1) {
+            leftRotate(pool[node].left);
+        }
+        rightRotate(node);
+    } else if (balance == 2) {
+        if (getBalance(pool[node].right) == -1) {
+            rightRotate(pool[node].right);
+        }
+        leftRotate(node);
+    }
+}
+
+template<typename type>
+void SwappingAVL<type>::retrace(NodeIndex* path, int64_t depth) {
+    while (depth > 0) {  // subtree sizes are already fixed on the way down
+        NodeIndex node = path[--depth];
+        int8_t height = pool[node].height;
+
+        updateHeight(node);
+        balance(node);
+        if (pool[node].height == height) {  // nodes above see the same subtree height
+            return;
+        }
+    }
+}
+
+template<typename type>
+void SwappingAVL<type>::add(const type& value) {
+    NodeIndex path[max_height];  // nodes from the root to the parent of the new node
+    int64_t depth = 0;
+    NodeIndex node = pool.allocate(value);
+    NodeIndex ptr = root;
+
+    ++size;
+    if (root == no_node) {
+        root = node;
+        return;
+    }
+    while (true) {
+        path[depth++] = ptr;
+        ++pool[ptr].count;  // the new node ends up in this subtree
+
+        NodeIndex& next = (pool[ptr].value > value) ? pool[ptr].left : pool[ptr].right;
+
+        if (next == no_node) {
+            next = node;
+            break;
+        }
+        ptr = next;
+    }
+    retrace(path, depth);
+}
+
+template<typename type>
+void SwappingAVL<type>::remove(const type& value) {
+    NodeIndex path[max_height];  // nodes from the root to the parent of the removed node
+    int64_t depth = 0;
+    NodeIndex ptr = root;
+
+    while ((ptr != no_node) && (pool[ptr].value != value)) {
+        path[depth++] = ptr;
+        ptr = (pool[ptr].value > value) ? pool[ptr].left : pool[ptr].right;
+    }
+    if (ptr == no_node) {
+        return;
+    }
+
+    NodeIndex removed = ptr;  // node that leaves the tree, the successor if ptr has two children
+
+    if ((pool[ptr].left != no_node) && (pool[ptr].right != no_node)) {
+        path[depth++] = ptr;
+        removed = pool[ptr].right;
+        while (pool[removed].left != no_node) {
+            path[depth++] = removed;
+            removed = pool[removed].left;
+        }
+    }
+    for (int64_t i = 0; i < depth; ++i) {
+        --pool[path[i]].count;
+    }
+
+    NodeIndex child = (pool[removed].left != no_node) ? pool[removed].left : pool[removed].right;
+
+    if (depth == 0) {
+        root = child;
+    } else if (pool[path[depth - 1]].left == removed) {
+        pool[path[depth - 1]].left = child;
+    } else {
+        pool[path[depth - 1]].right = child;
+    }
+    if (removed != ptr) {
+        pool[ptr].value = pool[removed].value;
+    }
+    pool.deallocate(removed);
+    --size;
+    retrace(path, depth);
+}
+
+template<typename type>
+int64_t SwappingAVL<type>::getSize() const {
+    return size;
+}
+
+template<typename type>
+bool SwappingAVL<type>::isClear() const {
+    return root == no_node;
+}
+
+struct Times {
+    double add = std::numeric_limits<double>::max();
+    double remove = std::numeric_limits<double>::max();
+};
+
+// the best of rounds for each phase, false if a size check failed
+template<typename type, typename tree_type>
+bool run(const char* name, const std::vector<int64_t>& keys, const int64_t& rounds, Times& times) {
+    for (int64_t round = 0; round < rounds; ++round) {
+        tree_type tree;
+        auto start = std::chrono::steady_clock::now();
+
+        for (int64_t key : keys) {
+            tree.add(type(key));
+        }
+
+        auto middle = std::chrono::steady_clock::now();
+
+        if (tree.getSize() != static_cast<int64_t>(keys.size())) {
+            std::cout << name << ": wrong size after add\n";
+            return false;
+        }
+        for (auto it = keys.rbegin(); it != keys.rend(); ++it) {
+            tree.remove(type(*it));
+        }
+
+        auto finish = std::chrono::steady_clock::now();
+
+        if (!tree.isClear()) {
+            std::cout << name << ": tree not empty after remove\n";
+            return false;
+        }
+        times.add = std::min(times.add, std::chrono::duration<double>(middle - start).count());
+        times.remove = std::min(times.remove, std::chrono::duration<double>(finish - middle).count());
+    }
+    return true;
+}
+
+// prints relinking and value-swapping side by side, false if a size check failed
+template<typename type>
+bool compare(const char* name, const std::vector<int64_t>& keys, const int64_t& rounds) {
+    Times relinking;
+    Times swapping;
+
+    if (!run<type, AVLSearchTree<type>>(name, keys, rounds, relinking) ||
+        !run<type, SwappingAVL<type>>(name, keys, rounds, swapping)) {
+        return false;
+    }
+    std::cout << std::setw(10) << name << std::setw(12) << relinking.add << std::setw(12) << relinking.remove
+              << std::setw(12) << swapping.add << std::setw(12) << swapping.remove << '\n';
+    return true;
+}
+
+int main(int argc, char** argv) {
+    int64_t count = (argc > 1) ? std::atoll(argv[1]) : 300000;
+    int64_t rounds = (argc > 2) ? std::atoll(argv[2]) : 3;
+    std::vector<int64_t> keys(count);
+    std::mt19937_64 random(1);
+
+    std::iota(keys.begin(), keys.end(), 0);
+    std::shuffle(keys.begin(), keys.end(), random);
+    std::cout << count << " elements, best of " << rounds << " rounds, seconds\n";
+    std::cout << std::setw(10) << "" << std::setw(24) << "relinking" << std::setw(24) << "value swapping" << '\n';
+    std::cout << std::setw(10) << "type" << std::setw(12) << "add" << std::setw(12) << "remove"
+              << std::setw(12) << "add" << std::setw(12) << "remove" << '\n';
+    if (!compare<int64_t>("int64_t", keys, rounds) || !compare<Record>("record", keys, rounds)) {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,127 @@
+// Copyright 2023 binoll
+// BinarySearchTree, AVLSearchTree, RedBlackTree and WAVLTree on the same mixed
+// traces of add, remove and find of random keys: insert-heavy (70/10/20),
+// delete-heavy (10/70/20) and lookup-heavy (5/5/90). Every tree starts with the
+// same keys, and its final size and number of found keys are checked against
+// the first tree.
+// usage: bench_balanced_trees [elements] [operations] [rounds]
+#include "../libs.hpp"
+#include "../data_structures/trees/bst.hpp"
+#include "../data_structures/trees/avl.hpp"
+#include "../data_structures/trees/red_black.hpp"
+#include "../data_structures/trees/wavl.hpp"
+
+enum class Kind { add, remove, find };
+
+struct Operation {
+    Kind kind;
+    int64_t key;
+};
+
+struct Trace {
+    const char* name;
+    int64_t add_percent;
+    int64_t remove_percent;  // the rest are finds
+    std::vector<Operation> operations;
+};
+
+struct Result {
+    double seconds = std::numeric_limits<double>::max();
+    int64_t size = 0;  // after the trace
+    int64_t found = 0;  // finds that hit
+};
+
+// the best of rounds; keys already present are not added, since the trees keep duplicates
+template<typename tree_type>
+Result run(const std::vector<int64_t>& initial, const Trace& trace, const int64_t& rounds) {
+    Result result;
+
+    for (int64_t round = 0; round < rounds; ++round) {
+        tree_type tree;
+        int64_t found = 0;
+
+        for (int64_t key : initial) {
+            tree.add(key);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+
+        for (const Operation& operation : trace.operations) {
+            if (operation.kind == Kind::add) {
+                if (!tree.find(operation.key)) {
+                    tree.add(operation.key);
+                }
+            } else if (operation.kind == Kind::remove) {
+                tree.remove(operation.key);
+            } else {
+                found += tree.find(operation.key);
+            }
+        }
+        result.seconds = std::min(result.seconds,
+                                  std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        result.size = tree.getSize();
+        result.found = found;
+    }
+    return result;
+}
+
+// prints the row of one tree, false if it disagrees with the expected results
+template<typename tree_type>
+bool row(const char* name, const std::vector<int64_t>& initial, const std::vector<Trace>& traces,
+         const int64_t& rounds, std::vector<Result>& expected) {
+    std::cout << std::setw(10) << name;
+    for (size_t t = 0; t < traces.size(); ++t) {
+        Result result = run<tree_type>(initial, traces[t], rounds);
+
+        std::cout << std::setw(14) << result.seconds << std::flush;
+        if (expected.size() <= t) {
+            expected.push_back(result);
+        } else if ((result.size != expected[t].size) || (result.found != expected[t].found)) {
+            std::cout << '\n' << name << ": wrong result on " << traces[t].name << '\n';
+            return false;
+        }
+    }
+    std::cout << '\n';
+    return true;
+}
+
+int main(int argc, char** argv) {
+    int64_t count = (argc > 1) ? std::atoll(argv[1]) : 200000;
+    int64_t operations = (argc > 2) ? std::atoll(argv[2]) : 1000000;
+    int64_t rounds = (argc > 3) ? std::atoll(argv[3]) : 3;
+    int64_t universe = 2 * count;  // about half of the keys are present at the start
+    std::mt19937_64 random(1);
+    std::vector<int64_t> initial(universe);
+    std::vector<Trace> traces = {{"insert-heavy", 70, 10, {}},
+                                 {"delete-heavy", 10, 70, {}},
+                                 {"lookup-heavy", 5, 5, {}}};
+    std::vector<Result> expected;
+
+    std::iota(initial.begin(), initial.end(), 0);
+    std::shuffle(initial.begin(), initial.end(), random);
+    initial.resize(count);
+    for (Trace& trace : traces) {
+        trace.operations.reserve(operations);
+        for (int64_t i = 0; i < operations; ++i) {
+            int64_t percent = static_cast<int64_t>(random() % 100);
+            Kind kind = (percent < trace.add_percent) ? Kind::add
+                      : (percent < trace.add_percent + trace.remove_percent) ? Kind::remove : Kind::find;
+
+            trace.operations.push_back({kind, static_cast<int64_t>(random() % universe)});
+        }
+    }
+
+    std::cout << count << " elements, " << operations << " operations, best of " << rounds << " rounds, seconds\n";
+    std::cout << std::setw(10) << "tree";
+    for (const Trace& trace : traces) {
+        std::cout << std::setw(14) << trace.name;
+    }
+    std::cout << '\n';
+    if (!row<BinarySearchTree<int64_t>>("bst", initial, traces, rounds, expected) ||
+        !row<AVLSearchTree<int64_t>>("avl", initial, traces, rounds, expected) ||
+        !row<RedBlackTree<int64_t>>("red-black", initial, traces, rounds, expected) ||
+        !row<WAVLTree<int64_t>>("wavl", initial, traces, rounds, expected)) {
+        return 1;
+    }
+    return 0;
+}
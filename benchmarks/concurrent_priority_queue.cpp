@@ -0,0 +1,124 @@
+// Copyright 2023 binoll
+// Throughput of ConcurrentPriorityQueue (MultiQueue) against one PriorityQueue
+// behind a mutex, for 1, 2, 4, ... threads doing alternating push and pop, and
+// the rank error of the MultiQueue pops: 0 when the true maximum comes out.
+// usage: bench_concurrent_priority_queue [max threads] [operations per thread]
+#include "../libs.hpp"
+#include "../data_structures/concurrent_priority_queue.hpp"
+
+template<typename function>
+double run(const int64_t& threads, function work) {
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+
+    for (int64_t t = 0; t < threads; ++t) {
+        workers.emplace_back(work, t);
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Every thread pops a prefilled queue and takes a ticket right after each pop.
+// Replaying the pops in ticket order against the priorities still present gives
+// the rank of each popped element. Returns the mean and max rank. With more
+// threads than cores a preempted thread stalls its shard (and its ticket), so the
+// error then also measures the scheduler.
+std::pair<double, int64_t> rankError(const int64_t& threads, const int64_t& count) {
+    ConcurrentPriorityQueue<int64_t> queue(threads);
+    std::vector<int64_t> priority_of_ticket(count);
+    std::atomic<int64_t> ticket{0};
+    std::vector<int64_t> tree(count + 1);  // Fenwick tree over priorities still present
+
+    for (int64_t i = 0; i < count; ++i) {
+        queue.push(i, (i * 7919) % count);  // 7919 is prime, so the priorities are a permutation
+    }
+    run(threads, [&](int64_t) {
+        QueueNode<int64_t> node;
+
+        while (queue.tryPopMax(node)) {
+            priority_of_ticket[ticket.fetch_add(1)] = node.getPriority();
+        }
+    });
+
+    auto update = [&](int64_t index, const int64_t& delta) {
+        for (++index; index <= count; index += index & -index) {
+            tree[index] += delta;
+        }
+    };
+    auto prefix = [&](int64_t index) {  // number of present priorities <= index
+        int64_t result = 0;
+
+        for (++index; index > 0; index -= index & -index) {
+            result += tree[index];
+        }
+        return result;
+    };
+    int64_t total = 0;
+    int64_t worst = 0;
+
+    for (int64_t i = 0; i < count; ++i) {
+        update(i, 1);
+    }
+    for (int64_t i = 0; i < count; ++i) {
+        int64_t rank = (count - i) - prefix(priority_of_ticket[i]);  // present and greater
+
+        total += rank;
+        worst = std::max(worst, rank);
+        update(priority_of_ticket[i], -1);
+    }
+    return {static_cast<double>(total) / count, worst};
+}
+
+int main(int argc, char** argv) {
+    int64_t max_threads = (argc > 1) ? std::atoll(argv[1])
+                                     : std::max<int64_t>(1, std::thread::hardware_concurrency());
+    int64_t operations = (argc > 2) ? std::atoll(argv[2]) : 1000000;
+    int64_t prefill = 100000;
+
+    std::cout << "threads  multiqueue Mops/s  locked heap Mops/s  mean rank  max rank\n";
+    for (int64_t threads = 1; threads <= max_threads; threads *= 2) {
+        ConcurrentPriorityQueue<int64_t> multi_queue(threads);
+        PriorityQueue<int64_t> heap;
+        std::mutex lock;
+
+        for (int64_t i = 0; i < prefill; ++i) {
+            multi_queue.push(i, (i * 7919) % prefill);
+            heap.push(i, (i * 7919) % prefill);
+        }
+
+        double multi_time = run(threads, [&](int64_t id) {
+            std::mt19937_64 random(id);
+            QueueNode<int64_t> node;
+
+            for (int64_t i = 0; i < operations; ++i) {
+                if (i % 2 == 0) {
+                    multi_queue.push(i, static_cast<int64_t>(random() % prefill));
+                } else {
+                    multi_queue.tryPopMax(node);
+                }
+            }
+        });
+        double locked_time = run(threads, [&](int64_t id) {
+            std::mt19937_64 random(id);
+
+            for (int64_t i = 0; i < operations; ++i) {
+                std::lock_guard<std::mutex> guard(lock);
+
+                if (i % 2 == 0) {
+                    heap.push(i, static_cast<int64_t>(random() % prefill));
+                } else {
+                    heap.popMax();
+                }
+            }
+        });
+        double total = static_cast<double>(threads * operations) / 1e6;
+        std::pair<double, int64_t> error = rankError(threads, prefill);
+
+        std::cout << std::setw(7) << threads << std::setw(19) << total / multi_time
+                  << std::setw(20) << total / locked_time << std::setw(11) << error.first
+                  << std::setw(10) << error.second << '\n';
+    }
+    return 0;
+}
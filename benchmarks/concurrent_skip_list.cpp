@@ -0,0 +1,105 @@
+// Copyright 2023 binoll
+// Throughput of ConcurrentSkipList against one AVLSearchTree behind a mutex, for
+// 1, 2, 4, ... threads. Writes are half add and half remove, 1% of the operations
+// are range scans of 100 keys and the rest are finds. Without a write percentage
+// every mix of 1%, 10% and 50% writes is measured.
+// usage: bench_concurrent_skip_list [max threads] [operations per thread] [keys] [write percent]
+#include "../libs.hpp"
+#include "../data_structures/concurrent_skip_list.hpp"
+#include "../data_structures/trees/avl.hpp"
+
+template<typename function>
+double run(const int64_t& threads, function work) {
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+
+    for (int64_t t = 0; t < threads; ++t) {
+        workers.emplace_back(work, t);
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    int64_t max_threads = (argc > 1) ? std::atoll(argv[1])
+                                     : std::max<int64_t>(1, std::thread::hardware_concurrency());
+    int64_t operations = (argc > 2) ? std::atoll(argv[2]) : 1000000;
+    int64_t keys = (argc > 3) ? std::atoll(argv[3]) : 200000;
+    std::vector<int64_t> mixes = {1, 10, 50};  // percent of writes
+
+    if (argc > 4) {
+        mixes = {std::atoll(argv[4])};
+    }
+
+    std::cout << " writes  threads  skip list Mops/s  locked avl Mops/s\n";
+    for (int64_t writes : mixes) {
+        int64_t adds = writes / 2;  // operation kinds below adds are add, below writes remove
+        int64_t finds = std::max<int64_t>(writes, 99);  // the rest are range scans
+
+        for (int64_t threads = 1; threads <= max_threads; threads *= 2) {
+            ConcurrentSkipList<int64_t> list;
+            AVLSearchTree<int64_t> tree;
+            std::mutex lock;
+
+            for (int64_t i = 0; i < keys; i += 2) {  // half of the keys present
+                list.add(i);
+                tree.add(i);
+            }
+
+            double list_time = run(threads, [&](int64_t id) {
+                std::mt19937_64 random(id);
+                int64_t seen = 0;
+
+                for (int64_t i = 0; i < operations; ++i) {
+                    int64_t key = static_cast<int64_t>(random() % keys);
+                    int64_t kind = static_cast<int64_t>(random() % 100);
+
+                    if (kind < adds) {
+                        list.add(key);
+                    } else if (kind < writes) {
+                        list.remove(key);
+                    } else if (kind < finds) {
+                        seen += list.find(key);
+                    } else {
+                        list.rangeForEach(key, key + 99, [&](const int64_t&) { ++seen; });
+                    }
+                }
+                if (seen < 0) {
+                    std::cout << seen;
+                }
+            });
+            double locked_time = run(threads, [&](int64_t id) {
+                std::mt19937_64 random(id);
+                int64_t seen = 0;
+
+                for (int64_t i = 0; i < operations; ++i) {
+                    int64_t key = static_cast<int64_t>(random() % keys);
+                    int64_t kind = static_cast<int64_t>(random() % 100);
+                    std::lock_guard<std::mutex> guard(lock);
+
+                    if (kind < adds) {
+                        if (!tree.find(key)) {  // the tree keeps duplicates, the set does not
+                            tree.add(key);
+                        }
+                    } else if (kind < writes) {
+                        tree.remove(key);
+                    } else if (kind < finds) {
+                        seen += tree.find(key);
+                    } else {
+                        seen += tree.countInRange(key, key + 99);
+                    }
+                }
+                if (seen < 0) {
+                    std::cout << seen;
+                }
+            });
+            double total = static_cast<double>(threads * operations) / 1e6;
+
+            std::cout << std::setw(6) << writes << '%' << std::setw(9) << threads << std::setw(18) << total / list_time
+                      << std::setw(19) << total / locked_time << '\n';
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,91 @@
+// Copyright 2023 binoll
+// Dijkstra on a random graph with the binary heap (PriorityQueue with
+// std::greater), RadixHeap and BucketQueue; the distances are checked to agree.
+// usage: bench_dijkstra [vertices] [edges per vertex] [max weight]
+#include "../libs.hpp"
+#include "../data_structures/priority_queue.hpp"
+#include "../data_structures/radix_heap.hpp"
+#include "../data_structures/bucket_queue.hpp"
+
+struct Graph {
+    std::vector<int64_t> first;  // edges of vertex v are first[v] .. first[v + 1] - 1
+    std::vector<int64_t> target;
+    std::vector<int64_t> weight;
+};
+
+// lazy Dijkstra: a vertex may be pushed several times, stale entries are skipped
+template<typename queue_type, typename pop_function>
+std::vector<int64_t> dijkstra(const Graph& graph, queue_type& queue, pop_function pop) {
+    int64_t count = static_cast<int64_t>(graph.first.size()) - 1;
+    std::vector<int64_t> distance(count, std::numeric_limits<int64_t>::max());
+
+    distance[0] = 0;
+    queue.push(0, 0);
+    while (queue.getSize() > 0) {
+        QueueNode<int64_t> node = pop(queue);
+        int64_t vertex = node.getValue();
+
+        if (node.getPriority() != distance[vertex]) {
+            continue;
+        }
+        for (int64_t e = graph.first[vertex]; e < graph.first[vertex + 1]; ++e) {
+            int64_t candidate = distance[vertex] + graph.weight[e];
+
+            if (candidate < distance[graph.target[e]]) {
+                distance[graph.target[e]] = candidate;
+                queue.push(graph.target[e], candidate);
+            }
+        }
+    }
+    return distance;
+}
+
+template<typename function>
+std::vector<int64_t> timed(const char* name, function run) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<int64_t> distance = run();
+
+    std::cout << std::setw(12) << name << ' '
+              << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() << " s\n";
+    return distance;
+}
+
+int main(int argc, char** argv) {
+    int64_t count = (argc > 1) ? std::atoll(argv[1]) : 1000000;
+    int64_t degree = (argc > 2) ? std::atoll(argv[2]) : 4;
+    int64_t max_weight = (argc > 3) ? std::atoll(argv[3]) : 100;
+    std::mt19937_64 random(1);
+    Graph graph;
+
+    graph.first.resize(count + 1);
+    for (int64_t v = 0; v < count; ++v) {
+        graph.first[v] = v * degree;
+        for (int64_t e = 0; e < degree; ++e) {
+            graph.target.push_back(static_cast<int64_t>(random() % count));
+            graph.weight.push_back(1 + static_cast<int64_t>(random() % max_weight));
+        }
+    }
+    graph.first[count] = count * degree;
+
+    std::vector<int64_t> heap_distance = timed("binary heap", [&]() {
+        PriorityQueue<int64_t, std::greater<int64_t>> queue;
+
+        return dijkstra(graph, queue, [](PriorityQueue<int64_t, std::greater<int64_t>>& q) { return q.popMax(); });
+    });
+    std::vector<int64_t> radix_distance = timed("radix heap", [&]() {
+        RadixHeap<int64_t> queue;
+
+        return dijkstra(graph, queue, [](RadixHeap<int64_t>& q) { return q.popMin(); });
+    });
+    std::vector<int64_t> bucket_distance = timed("bucket queue", [&]() {
+        BucketQueue<int64_t> queue(max_weight);
+
+        return dijkstra(graph, queue, [](BucketQueue<int64_t>& q) { return q.popMin(); });
+    });
+
+    if ((heap_distance != radix_distance) || (heap_distance != bucket_distance)) {
+        std::cout << "distances differ\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,45 @@
+// Copyright 2023 binoll
+// Disk traffic of ExternalPriorityQueue: push n random priorities, then pop
+// them all, for several memory budgets and block sizes, and report the bytes
+// written and read against the bytes of data.
+// usage: bench_external_priority_queue [elements]
+#include "../libs.hpp"
+#include "../data_structures/external_priority_queue.hpp"
+
+int main(int argc, char** argv) {
+    int64_t count = (argc > 1) ? std::atoll(argv[1]) : 200000;
+    std::vector<std::pair<int64_t, int64_t>> configs = {  // memory budget, block size
+        {64, 4096}, {4096, 4096}, {4096, 16}, {1 << 16, 1 << 12}, {1 << 20, 1 << 12}, {1 << 24, 1 << 20}};
+    double data = static_cast<double>(count) * 16 / (1 << 20);  // an int64_t value and its priority
+
+    std::cout << "data " << data << " MiB\n";
+    std::cout << "    budget     block  fan-in  written MiB    read MiB      time s\n";
+    for (const auto& config : configs) {
+        ExternalPriorityQueue<int64_t> queue(config.first, config.second);
+        std::mt19937_64 random(1);
+        int64_t last = std::numeric_limits<int64_t>::max();
+        auto start = std::chrono::steady_clock::now();
+
+        for (int64_t i = 0; i < count; ++i) {
+            queue.push(i, static_cast<int64_t>(random() >> 1));
+        }
+        while (!queue.isClear()) {
+            int64_t priority = queue.popMax().getPriority();
+
+            if (priority > last) {
+                std::cout << "wrong order\n";
+                return 1;
+            }
+            last = priority;
+        }
+
+        double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << std::setw(10) << config.first << std::setw(10) << config.second
+                  << std::setw(8) << queue.getFanIn()
+                  << std::setw(13) << static_cast<double>(queue.getWrittenBytes()) / (1 << 20)
+                  << std::setw(12) << static_cast<double>(queue.getReadBytes()) / (1 << 20)
+                  << std::setw(12) << time << '\n';
+    }
+    return 0;
+}
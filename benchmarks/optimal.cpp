@@ -0,0 +1,122 @@
+// Copyright 2023 binoll
+// Expected search cost of the trees from buildOptimalTree, buildWeightBalancedTree
+// and buildAlphabeticTree on the same frequencies, as comparisons per search next
+// to the exact optimum, and the time of the Garsia-Wachs builder on many leaves.
+// usage: bench_optimal [keys] [leaves]
+#include "../libs.hpp"
+#include "../data_structures/trees/optimal.hpp"
+
+struct Frequencies {
+    const char* name;
+    std::vector<int64_t> successful;  // searches for key i
+    std::vector<int64_t> unsuccessful;  // searches that end between keys i - 1 and i
+};
+
+double since(const std::chrono::steady_clock::time_point& start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// builds one tree, prints its comparisons per search and build time, returns the total cost
+template<typename function>
+int64_t measure(const Frequencies& frequencies, const std::vector<int64_t>& keys, function build) {
+    int64_t total = std::accumulate(frequencies.successful.begin(), frequencies.successful.end(), int64_t(0)) +
+                    std::accumulate(frequencies.unsuccessful.begin(), frequencies.unsuccessful.end(), int64_t(0));
+    BinarySearchTree<int64_t> tree;
+    auto start = std::chrono::steady_clock::now();
+
+    build(tree, keys.data(), frequencies.successful.data(), static_cast<int64_t>(keys.size()),
+          frequencies.unsuccessful.data());
+
+    double seconds = since(start);
+    int64_t cost = tree.getSearchCost(frequencies.successful.data(), frequencies.unsuccessful.data());
+
+    std::cout << std::setw(10) << static_cast<double>(cost) / static_cast<double>(total)
+              << std::setw(12) << seconds;
+    return cost;
+}
+
+int main(int argc, char** argv) {
+    int64_t count = (argc > 1) ? std::atoll(argv[1]) : 2000;
+    int64_t leaves = (argc > 2) ? std::atoll(argv[2]) : 1000000;
+    std::mt19937_64 random(1);
+    std::vector<int64_t> keys(count);
+    std::vector<Frequencies> workloads;
+
+    std::iota(keys.begin(), keys.end(), 0);
+    workloads.push_back({"uniform", std::vector<int64_t>(count), std::vector<int64_t>(count + 1)});
+    workloads.push_back({"zipf", std::vector<int64_t>(count), std::vector<int64_t>(count + 1)});
+    workloads.push_back({"gaps only", std::vector<int64_t>(count), std::vector<int64_t>(count + 1)});
+    for (int64_t i = 0; i < count; ++i) {
+        workloads[0].successful[i] = static_cast<int64_t>(random() % 1000);
+        workloads[1].successful[i] = 1000000 / (i + 1);  // shuffled below
+    }
+    std::shuffle(workloads[1].successful.begin(), workloads[1].successful.end(), random);
+    for (int64_t i = 0; i <= count; ++i) {
+        workloads[0].unsuccessful[i] = static_cast<int64_t>(random() % 1000);
+        workloads[1].unsuccessful[i] = static_cast<int64_t>(random() % 10);
+        workloads[2].unsuccessful[i] = static_cast<int64_t>(random() % 1000);
+    }
+
+    std::cout << count << " keys, comparisons per search and build seconds\n";
+    std::cout << std::setw(10) << "workload" << std::setw(10) << "optimal" << std::setw(12) << "seconds"
+              << std::setw(10) << "weighted" << std::setw(12) << "seconds"
+              << std::setw(10) << "alphabet" << std::setw(12) << "seconds" << '\n';
+    for (const Frequencies& frequencies : workloads) {
+        std::cout << std::setw(10) << frequencies.name;
+
+        int64_t optimal = measure(frequencies, keys, [](BinarySearchTree<int64_t>& tree, const int64_t* values,
+                                                        const int64_t* successful, const int64_t& n,
+                                                        const int64_t* unsuccessful) {
+            tree.buildOptimalTree(values, successful, n, unsuccessful);
+        });
+        int64_t weighted = measure(frequencies, keys, [](BinarySearchTree<int64_t>& tree, const int64_t* values,
+                                                         const int64_t* successful, const int64_t& n,
+                                                         const int64_t* unsuccessful) {
+            tree.buildWeightBalancedTree(values, successful, n, unsuccessful);
+        });
+
+        if (weighted < optimal) {
+            std::cout << "\nweight-balanced tree beats the optimum\n";
+            return 1;
+        }
+        if (std::any_of(frequencies.successful.begin(), frequencies.successful.end(),
+                        [](const int64_t& frequency) { return frequency != 0; })) {
+            std::cout << std::setw(10) << "-" << std::setw(12) << "-" << '\n';  // Garsia-Wachs needs leaf-only weights
+            continue;
+        }
+        if (measure(frequencies, keys, [](BinarySearchTree<int64_t>& tree, const int64_t* values,
+                                          const int64_t* successful, const int64_t& n,
+                                          const int64_t* unsuccessful) {
+            tree.buildAlphabeticTree(values, successful, n, unsuccessful);
+        }) != optimal) {
+            std::cout << "\nalphabetic tree is not optimal\n";
+            return 1;
+        }
+        std::cout << '\n';
+    }
+
+    std::vector<int64_t> big_keys(leaves - 1);
+    std::vector<int64_t> zeros(leaves - 1, 0);
+    std::vector<int64_t> weights(leaves);
+
+    std::iota(big_keys.begin(), big_keys.end(), 0);
+    std::cout << "\nbuildAlphabeticTree on " << leaves << " leaves, seconds\n";
+    for (int64_t order = 0; order < 3; ++order) {
+        const char* names[] = {"random", "decreasing", "increasing"};
+
+        for (int64_t i = 0; i < leaves; ++i) {
+            weights[i] = (order == 0) ? static_cast<int64_t>(random() % 1000000) : (order == 1) ? leaves - i : i + 1;
+        }
+
+        BinarySearchTree<int64_t> tree;
+        auto start = std::chrono::steady_clock::now();
+
+        tree.buildAlphabeticTree(big_keys.data(), zeros.data(), leaves - 1, weights.data());
+        std::cout << std::setw(10) << names[order] << std::setw(12) << since(start) << '\n';
+        if (tree.getSize() != leaves - 1) {
+            std::cout << "wrong size\n";
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,115 @@
+// Copyright 2023 binoll
+#pragma once
+
+#include "../libs.hpp"
+#include "priority_queue.hpp"
+
+// Monotone min-priority queue for a small key range (Dial's algorithm): every
+// pushed priority must lie in [last popped, last popped + range], starting from 0.
+// Elements are kept in a circular array of range + 1 buckets, so push is O(1)
+// and popMin scans at most range + 1 buckets.
+template<typename type>
+class BucketQueue {
+ public:
+    explicit BucketQueue(const int64_t& range);  // constructor, range is the max priority spread
+
+    ~BucketQueue() = default;  // destructor
+
+    void push(const type& value, const int64_t& priority);  // push element
+
+    QueueNode<type> popMin();  // pop element with min priority
+
+    QueueNode<type> findMin();  // find element with min priority
+
+    void clear();  // clear queue
+
+    bool isClear() const;  // checking for emptiness
+
+    int64_t getSize() const;  // return size of the queue
+
+ private:
+    void advance();  // move current to the first non-empty bucket
+
+    std::vector<std::vector<type>> buckets;  // bucket i holds priorities equal to i modulo range + 1
+    int64_t range = 0;  // max difference between a pushed priority and the current minimum
+    int64_t current = 0;  // priority of the current bucket
+    int64_t size = 0;  // current size of the queue
+};
+
+template<typename type>
+BucketQueue<type>::BucketQueue(const int64_t& range) : range(range) {
+    try {
+        buckets.resize(range + 1);
+    } catch (...) {
+        std::cout << "\nProblems with constructor\n";
+    }
+}
+
+template<typename type>
+void BucketQueue<type>::push(const type& value, const int64_t& priority) {
+    if ((priority < current) || (priority - current > range)) {
+        std::cout << "\nProblems with push method: priority is out of range!\n";
+        return;
+    }
+    try {
+        buckets[priority % (range + 1)].push_back(value);
+        ++size;
+    } catch (...) {
+        std::cout << "\nProblems with push method!\n";
+    }
+}
+
+template<typename type>
+void BucketQueue<type>::advance() {
+    int64_t index = current % (range + 1);
+
+    while (buckets[index].empty()) {
+        ++current;
+        index = (index == range) ? 0 : index + 1;
+    }
+}
+
+template<typename type>
+QueueNode<type> BucketQueue<type>::popMin() {
+    if (size == 0) {
+        std::cout << "\nProblems with pop method!\n";
+        return QueueNode<type>();
+    }
+    advance();
+
+    std::vector<type>& bucket = buckets[current % (range + 1)];
+    QueueNode<type> node(bucket.back(), current);
+
+    bucket.pop_back();
+    --size;
+    return node;
+}
+
+template<typename type>
+QueueNode<type> BucketQueue<type>::findMin() {
+    if (size == 0) {
+        std::cout << "\nProblems with find method!\n";
+        return QueueNode<type>();
+    }
+    advance();
+    return QueueNode<type>(buckets[current % (range + 1)].back(), current);
+}
+
+template<typename type>
+void BucketQueue<type>::clear() {
+    for (auto& bucket : buckets) {
+        bucket.clear();
+    }
+    current = 0;
+    size = 0;
+}
+
+template<typename type>
+bool BucketQueue<type>::isClear() const {
+    return size == 0;
+}
+
+template<typename type>
+int64_t BucketQueue<type>::getSize() const {
+    return size;
+}
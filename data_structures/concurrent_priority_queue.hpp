@@ -0,0 +1,154 @@
+// Copyright 2023 binoll
+#pragma once
+
+#include "../libs.hpp"
+#include "priority_queue.hpp"
+
+// Relaxed concurrent priority queue (MultiQueue): the elements are spread over
+// several independently locked heaps. push goes to a random heap, tryPopMax
+// looks at the tops of two random heaps and pops the larger one. The popped
+// element is not always the global maximum, but its expected rank is O(number of heaps).
+template<typename type>
+class ConcurrentPriorityQueue {
+ public:
+    explicit ConcurrentPriorityQueue(const int64_t& threads,
+                                     const int64_t& factor = 2);  // constructor, threads * factor heaps
+
+    ConcurrentPriorityQueue(const ConcurrentPriorityQueue<type>& queue) = delete;
+
+    ConcurrentPriorityQueue<type>& operator=(const ConcurrentPriorityQueue<type>& queue) = delete;
+
+    ~ConcurrentPriorityQueue();  // destructor
+
+    void push(const type& value, const int64_t& priority);  // push element, thread-safe
+
+    bool tryPopMax(QueueNode<type>& node);  // pop element with (approximately) max priority, false if empty
+
+    int64_t getSize() const;  // return size of the queue
+
+    int64_t getQueueCount() const;  // return number of internal heaps
+
+ private:
+    struct alignas(64) Shard {  // neighbouring shards never share a cache line
+        std::mutex lock;  // protects queue
+        PriorityQueue<type> queue;  // heap of this shard
+        std::atomic<int64_t> top{empty_top};  // cached max priority, readable without the lock
+    };
+
+    int64_t randomIndex() const;  // random shard index for the calling thread
+
+    static constexpr int64_t empty_top = std::numeric_limits<int64_t>::min();  // top of an empty shard
+
+    void* memory = nullptr;  // storage of shards, new[] does not honour alignas before C++17
+    Shard* shards = nullptr;  // array of heaps, aligned inside memory
+    int64_t count = 0;  // number of heaps
+    std::atomic<int64_t> size{0};  // number of elements in all heaps
+};
+
+template<typename type>
+constexpr int64_t ConcurrentPriorityQueue<type>::empty_top;
+
+template<typename type>
+ConcurrentPriorityQueue<type>::ConcurrentPriorityQueue(const int64_t& threads,
+                                                       const int64_t& factor) {
+    try {
+        count = std::max<int64_t>(2, threads * factor);
+
+        std::size_t space = count * sizeof(Shard) + alignof(Shard);
+        void* aligned = nullptr;
+
+        memory = ::operator new(space);
+        aligned = memory;
+        shards = static_cast<Shard*>(std::align(alignof(Shard), count * sizeof(Shard), aligned, space));
+        for (int64_t i = 0; i < count; ++i) {
+            new (shards + i) Shard();
+        }
+    } catch (...) {
+        ::operator delete(memory);
+        memory = nullptr;
+        shards = nullptr;
+        count = 0;
+        std::cout << "\nProblems with constructor\n";
+    }
+}
+
+template<typename type>
+ConcurrentPriorityQueue<type>::~ConcurrentPriorityQueue() {
+    for (int64_t i = 0; i < count; ++i) {
+        shards[i].~Shard();
+    }
+    ::operator delete(memory);
+    memory = nullptr;
+    shards = nullptr;
+    count = 0;
+}
+
+template<typename type>
+int64_t ConcurrentPriorityQueue<type>::randomIndex() const {
+    thread_local uint64_t state = std::hash<std::thread::id>()(std::this_thread::get_id()) | 1;
+
+    state ^= state << 13;  // xorshift64
+    state ^= state >> 7;
+    state ^= state << 17;
+    return static_cast<int64_t>(state % static_cast<uint64_t>(count));
+}
+
+template<typename type>
+void ConcurrentPriorityQueue<type>::push(const type& value, const int64_t& priority) {
+    if (count == 0) {
+        std::cout << "\nProblems with push method!\n";
+        return;
+    }
+    while (true) {
+        Shard& shard = shards[randomIndex()];
+
+        if (!shard.lock.try_lock()) {  // busy, try another heap
+            continue;
+        }
+        shard.queue.push(value, priority);
+        shard.top.store(shard.queue.findMax().getPriority(), std::memory_order_relaxed);
+        size.fetch_add(1, std::memory_order_relaxed);
+        shard.lock.unlock();
+        return;
+    }
+}
+
+template<typename type>
+bool ConcurrentPriorityQueue<type>::tryPopMax(QueueNode<type>& node) {
+    while (size.load(std::memory_order_relaxed) > 0) {
+        int64_t first = randomIndex();
+        int64_t second = randomIndex();
+
+        if (shards[second].top.load(std::memory_order_relaxed) >
+            shards[first].top.load(std::memory_order_relaxed)) {
+            first = second;
+        }
+
+        Shard& shard = shards[first];
+
+        if (!shard.lock.try_lock()) {
+            continue;
+        }
+        if (shard.queue.getSize() == 0) {  // picked an empty heap
+            shard.lock.unlock();
+            continue;
+        }
+        node = shard.queue.popMax();
+        shard.top.store((shard.queue.getSize() == 0) ? empty_top : shard.queue.findMax().getPriority(),
+                        std::memory_order_relaxed);
+        size.fetch_sub(1, std::memory_order_relaxed);
+        shard.lock.unlock();
+        return true;
+    }
+    return false;
+}
+
+template<typename type>
+int64_t ConcurrentPriorityQueue<type>::getSize() const {
+    return size.load(std::memory_order_relaxed);
+}
+
+template<typename type>
+int64_t ConcurrentPriorityQueue<type>::getQueueCount() const {
+    return count;
+}
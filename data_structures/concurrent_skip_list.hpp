@@ -0,0 +1,506 @@
+// Copyright 2023 binoll
+#pragma once
+
+#include "../libs.hpp"
+
+template<typename type>
+class SkipNode {
+ public:
+    SkipNode(const type& value, const int64_t& height);  // constructor with parameters
+
+    ~SkipNode() = default;  // destructor
+
+    type value;  // value
+    int64_t height = 0;  // number of levels the node is linked on
+    std::unique_ptr<std::atomic<SkipNode<type>*>[]> next;  // next node on every level
+    std::atomic<uint64_t> version{0};  // number of changes of next[0]
+    std::atomic<bool> marked{false};  // logically removed
+    std::atomic<bool> linked{false};  // linked on all its levels, logically present unless marked
+    std::mutex lock;  // taken by writers that change next or marked
+    SkipNode<type>* retired = nullptr;  // next removed node waiting to be freed
+};
+
+// Concurrent ordered set: a lazy skip list (Herlihy, Lev, Luchangco and
+// Shavit). find takes no locks. add and remove search without locks, then lock
+// only the predecessors they change and validate that those are still
+// unmarked and adjacent; on a conflict they search again. Keys are unique.
+// rangeForEach is linearizable: it reads the bottom level of the range twice,
+// including a version that every change of a bottom link bumps, and uses the
+// result once two passes agree. Removed nodes are freed with epoch-based
+// reclamation: every operation announces the global epoch in a slot, a removed
+// node goes to the list of the epoch of its remover, and the epoch advances once
+// every active slot has seen it. The list of two epochs back can no longer be
+// reached by anyone and is freed, so memory follows the live set.
+template<typename type>
+class ConcurrentSkipList {
+ public:
+    ConcurrentSkipList();  // constructor without parameters
+
+    ConcurrentSkipList(const ConcurrentSkipList<type>& list) = delete;
+
+    ConcurrentSkipList<type>& operator=(const ConcurrentSkipList<type>& list) = delete;
+
+    ~ConcurrentSkipList();  // destructor
+
+    bool find(const type& value) const;  // searching for an element, thread-safe
+
+    bool add(const type& value);  // add element, false if it is already present, thread-safe
+
+    bool remove(const type& value);  // delete element, false if it is absent, thread-safe
+
+    template<typename function>
+    void rangeForEach(const type& low, const type& high,
+                      function fn) const;  // call fn for a snapshot of elements in [low, high], thread-safe
+
+    bool isClear() const;  // checking for emptiness
+
+    void clear();  // cleaning the list, not thread-safe
+
+    int64_t getSize() const;  // return number of elements
+
+ private:
+    class Guard {  // announces the epoch of the calling thread for one operation
+     public:
+        explicit Guard(const ConcurrentSkipList<type>* list);  // constructor, waits for a free slot
+
+        ~Guard();  // destructor, leaves the slot
+
+        uint64_t getEpoch() const;  // epoch of the operation
+
+     private:
+        std::atomic<uint64_t>* slot = nullptr;  // announced epoch
+        uint64_t epoch = 0;  // epoch of the operation
+    };
+
+    struct Step {
+        const SkipNode<type>* node;  // visited node
+        uint64_t version;  // its version when visited
+        bool present;  // linked and not marked when visited
+    };
+
+    int64_t findNodes(const type& value, SkipNode<type>** preds,
+                      SkipNode<type>** succs) const;  // top level where value was seen, -1 if not seen
+
+    static void unlockNodes(SkipNode<type>** preds, const int64_t& highest);  // unlock preds[0..highest]
+
+    void collect(const type& low, const type& high,
+                 std::vector<Step>& steps) const;  // one pass over the bottom level of the range
+
+    int64_t randomHeight() const;  // height of a new node, 1 + geometric(1/2)
+
+    void retire(SkipNode<type>* node, const uint64_t& announced);  // free removed node once no one can reach it
+
+    void tryAdvance();  // advance the epoch if every active slot has seen it, free the list two epochs back
+
+    static void freeList(SkipNode<type>* node);  // free a list of retired nodes
+
+    static constexpr int64_t max_height = 32;  // enough for 2^32 elements
+
+    static constexpr int64_t slot_count = 64;  // threads inside operations at once, more wait for a slot
+
+    static constexpr int64_t slot_stride = 8;  // slots 64 bytes apart never share a cache line
+
+    static constexpr int64_t reclaim_period = 64;  // removes between attempts to advance the epoch
+
+    static constexpr uint64_t idle = std::numeric_limits<uint64_t>::max();  // slot of no operation
+
+    SkipNode<type>* head = nullptr;  // sentinel before every element, linked on all levels
+    std::unique_ptr<std::atomic<uint64_t>[]> slots;  // slot i is slots[i * slot_stride]
+    std::atomic<uint64_t> epoch{0};  // global epoch
+    std::atomic<SkipNode<type>*> retired[4];  // removed nodes by epoch modulo 4
+    std::atomic<int64_t> removes{0};  // number of retired nodes, paces tryAdvance
+    std::atomic<int64_t> size{0};  // number of elements
+};
+
+template<typename type>
+constexpr int64_t ConcurrentSkipList<type>::max_height;
+
+template<typename type>
+constexpr int64_t ConcurrentSkipList<type>::slot_count;
+
+template<typename type>
+constexpr int64_t ConcurrentSkipList<type>::slot_stride;
+
+template<typename type>
+constexpr int64_t ConcurrentSkipList<type>::reclaim_period;
+
+template<typename type>
+constexpr uint64_t ConcurrentSkipList<type>::idle;
+
+template<typename type>
+SkipNode<type>::SkipNode(const type& value, const int64_t& height)
+    : value(value), height(height), next(new std::atomic<SkipNode<type>*>[height]) {
+    for (int64_t i = 0; i < height; ++i) {
+        next[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+template<typename type>
+ConcurrentSkipList<type>::ConcurrentSkipList()
+    : head(new SkipNode<type>(type(), max_height)),
+      slots(new std::atomic<uint64_t>[slot_count * slot_stride]) {
+    head->linked.store(true, std::memory_order_relaxed);
+    for (int64_t i = 0; i < slot_count; ++i) {
+        slots[i * slot_stride].store(idle, std::memory_order_relaxed);
+    }
+    for (std::atomic<SkipNode<type>*>& list : retired) {
+        list.store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+template<typename type>
+ConcurrentSkipList<type>::Guard::Guard(const ConcurrentSkipList<type>* list) {
+    thread_local uint64_t start = std::hash<std::thread::id>()(std::this_thread::get_id());
+
+    for (uint64_t i = start; slot == nullptr; ++i) {  // usually the first slot tried is free
+        std::atomic<uint64_t>& candidate = list->slots[(i % slot_count) * slot_stride];
+        uint64_t expected = idle;
+
+        epoch = list->epoch.load();
+        if (candidate.compare_exchange_strong(expected, epoch)) {
+            slot = &candidate;
+        } else if (i % slot_count == slot_count - 1) {
+            std::this_thread::yield();
+        }
+    }
+    while (list->epoch.load() != epoch) {  // the epoch moved before the slot was seen, announce again
+        epoch = list->epoch.load();
+        slot->store(epoch);
+    }
+}
+
+template<typename type>
+ConcurrentSkipList<type>::Guard::~Guard() {
+    slot->store(idle, std::memory_order_release);
+}
+
+template<typename type>
+uint64_t ConcurrentSkipList<type>::Guard::getEpoch() const {
+    return epoch;
+}
+
+template<typename type>
+ConcurrentSkipList<type>::~ConcurrentSkipList() {
+    clear();
+    delete head;
+}
+
+template<typename type>
+int64_t ConcurrentSkipList<type>::randomHeight() const {
+    thread_local uint64_t state = std::hash<std::thread::id>()(std::this_thread::get_id()) | 1;
+
+    state ^= state << 13;  // xorshift64
+    state ^= state >> 7;
+    state ^= state << 17;
+    return 1 + __builtin_ctzll(state | (1ULL << (max_height - 1)));
+}
+
+template<typename type>
+int64_t ConcurrentSkipList<type>::findNodes(const type& value, SkipNode<type>** preds,
+                                            SkipNode<type>** succs) const {
+    int64_t found = -1;
+    SkipNode<type>* pred = head;
+
+    for (int64_t level = max_height - 1; level >= 0; --level) {
+        SkipNode<type>* curr = pred->next[level].load(std::memory_order_acquire);
+
+        while ((curr != nullptr) && (curr->value < value)) {
+            pred = curr;
+            curr = pred->next[level].load(std::memory_order_acquire);
+        }
+        if ((found == -1) && (curr != nullptr) && !(value < curr->value)) {
+            found = level;
+        }
+        preds[level] = pred;
+        succs[level] = curr;
+    }
+    return found;
+}
+
+template<typename type>
+void ConcurrentSkipList<type>::unlockNodes(SkipNode<type>** preds, const int64_t& highest) {
+    for (int64_t level = 0; level <= highest; ++level) {
+        if ((level == 0) || (preds[level] != preds[level - 1])) {
+            preds[level]->lock.unlock();
+        }
+    }
+}
+
+template<typename type>
+void ConcurrentSkipList<type>::retire(SkipNode<type>* node, const uint64_t& announced) {
+    std::atomic<SkipNode<type>*>& list = retired[announced % 4];
+
+    node->retired = list.load(std::memory_order_relaxed);
+    while (!list.compare_exchange_weak(node->retired, node, std::memory_order_release,
+                                       std::memory_order_relaxed)) {}
+    if (removes.fetch_add(1, std::memory_order_relaxed) % reclaim_period == reclaim_period - 1) {
+        tryAdvance();
+    }
+}
+
+template<typename type>
+void ConcurrentSkipList<type>::tryAdvance() {
+    uint64_t current = epoch.load();
+
+    for (int64_t i = 0; i < slot_count; ++i) {
+        uint64_t announced = slots[i * slot_stride].load();
+
+        if ((announced != idle) && (announced != current)) {
+            return;  // someone may still stand on nodes retired in the previous epoch
+        }
+    }
+
+    if (!epoch.compare_exchange_strong(current, current + 1)) {
+        return;  // someone else advanced it
+    }
+
+    // nodes retired two epochs back: everyone who saw them announced an older
+    // epoch and has left. The caller still holds the old epoch, so the epoch
+    // cannot move on and refill this list before it is taken
+    freeList(retired[(current + 2) % 4].exchange(nullptr, std::memory_order_acquire));
+}
+
+template<typename type>
+void ConcurrentSkipList<type>::freeList(SkipNode<type>* node) {
+    while (node != nullptr) {
+        SkipNode<type>* next = node->retired;
+
+        delete node;
+        node = next;
+    }
+}
+
+template<typename type>
+bool ConcurrentSkipList<type>::find(const type& value) const {
+    Guard guard(this);
+    SkipNode<type>* preds[max_height];
+    SkipNode<type>* succs[max_height];
+    int64_t found = findNodes(value, preds, succs);
+
+    return (found != -1) && succs[found]->linked.load(std::memory_order_acquire) &&
+           !succs[found]->marked.load(std::memory_order_acquire);
+}
+
+template<typename type>
+bool ConcurrentSkipList<type>::add(const type& value) {
+    Guard guard(this);
+    SkipNode<type>* preds[max_height];
+    SkipNode<type>* succs[max_height];
+    int64_t height = randomHeight();
+
+    try {
+        while (true) {
+            int64_t found = findNodes(value, preds, succs);
+
+            if (found != -1) {
+                SkipNode<type>* node = succs[found];
+
+                if (!node->marked.load(std::memory_order_acquire)) {
+                    while (!node->linked.load(std::memory_order_acquire)) {  // wait for the concurrent add
+                        std::this_thread::yield();
+                    }
+                    return false;
+                }
+                std::this_thread::yield();  // being removed, search again
+                continue;
+            }
+
+            int64_t highest = -1;
+            bool valid = true;
+
+            for (int64_t level = 0; valid && (level < height); ++level) {
+                SkipNode<type>* pred = preds[level];
+                SkipNode<type>* succ = succs[level];
+
+                if ((level == 0) || (pred != preds[level - 1])) {
+                    pred->lock.lock();
+                }
+                highest = level;
+                valid = !pred->marked.load(std::memory_order_relaxed) &&
+                        ((succ == nullptr) || !succ->marked.load(std::memory_order_relaxed)) &&
+                        (pred->next[level].load(std::memory_order_relaxed) == succ);
+            }
+            if (!valid) {
+                unlockNodes(preds, highest);
+                continue;
+            }
+
+            SkipNode<type>* node = nullptr;
+
+            try {
+                node = new SkipNode<type>(value, height);
+            } catch (...) {
+                unlockNodes(preds, highest);
+                throw;
+            }
+            for (int64_t level = 0; level < height; ++level) {
+                node->next[level].store(succs[level], std::memory_order_relaxed);
+            }
+            for (int64_t level = 0; level < height; ++level) {  // bottom first, so a linked node is in the set
+                preds[level]->next[level].store(node, std::memory_order_release);
+            }
+            node->linked.store(true, std::memory_order_release);  // before the version, so a scan that
+            preds[0]->version.fetch_add(1, std::memory_order_release);  // saw it unlinked sees the change
+            size.fetch_add(1, std::memory_order_relaxed);
+            unlockNodes(preds, highest);
+            return true;
+        }
+    } catch (...) {
+        std::cout << "\nAdd method threw except\n";
+        return false;
+    }
+}
+
+template<typename type>
+bool ConcurrentSkipList<type>::remove(const type& value) {
+    Guard guard(this);
+    SkipNode<type>* preds[max_height];
+    SkipNode<type>* succs[max_height];
+    SkipNode<type>* victim = nullptr;
+
+    while (true) {
+        int64_t found = findNodes(value, preds, succs);
+
+        if (victim == nullptr) {
+            if (found == -1) {
+                return false;
+            }
+
+            SkipNode<type>* node = succs[found];
+
+            if (!node->linked.load(std::memory_order_acquire) || (node->height - 1 != found) ||
+                node->marked.load(std::memory_order_acquire)) {
+                return false;  // not fully added yet or already being removed
+            }
+            node->lock.lock();
+            if (node->marked.load(std::memory_order_relaxed)) {
+                node->lock.unlock();
+                return false;
+            }
+            node->marked.store(true, std::memory_order_release);  // the remove takes effect here
+            victim = node;
+        }
+
+        int64_t highest = -1;
+        bool valid = true;
+
+        for (int64_t level = 0; valid && (level < victim->height); ++level) {
+            SkipNode<type>* pred = preds[level];
+
+            if ((level == 0) || (pred != preds[level - 1])) {
+                pred->lock.lock();
+            }
+            highest = level;
+            valid = !pred->marked.load(std::memory_order_relaxed) &&
+                    (pred->next[level].load(std::memory_order_relaxed) == victim);
+        }
+        if (!valid) {
+            unlockNodes(preds, highest);
+            continue;
+        }
+        for (int64_t level = victim->height - 1; level >= 0; --level) {
+            preds[level]->next[level].store(victim->next[level].load(std::memory_order_relaxed),
+                                            std::memory_order_release);
+        }
+        preds[0]->version.fetch_add(1, std::memory_order_release);
+        size.fetch_sub(1, std::memory_order_relaxed);
+        victim->lock.unlock();
+        unlockNodes(preds, highest);
+        retire(victim, guard.getEpoch());
+        return true;
+    }
+}
+
+template<typename type>
+void ConcurrentSkipList<type>::collect(const type& low, const type& high, std::vector<Step>& steps) const {
+    const SkipNode<type>* pred = head;
+
+    steps.clear();
+    for (int64_t level = max_height - 1; level >= 0; --level) {
+        const SkipNode<type>* curr = pred->next[level].load(std::memory_order_acquire);
+
+        while ((curr != nullptr) && (curr->value < low) &&
+               !curr->marked.load(std::memory_order_acquire)) {  // start from a node still in the list
+            pred = curr;
+            curr = pred->next[level].load(std::memory_order_acquire);
+        }
+    }
+    for (const SkipNode<type>* node = pred; ; ) {
+        uint64_t version = node->version.load(std::memory_order_acquire);
+        bool present = node->linked.load(std::memory_order_acquire) &&
+                       !node->marked.load(std::memory_order_acquire);
+
+        steps.push_back(Step{node, version, present});
+        if ((node != head) && (high < node->value)) {
+            return;
+        }
+        node = node->next[0].load(std::memory_order_acquire);
+        if (node == nullptr) {
+            steps.push_back(Step{nullptr, 0, false});
+            return;
+        }
+    }
+}
+
+template<typename type>
+template<typename function>
+void ConcurrentSkipList<type>::rangeForEach(const type& low, const type& high, function fn) const {
+    Guard guard(this);  // also keeps the addresses in the passes from being reused
+    std::vector<Step> first;
+    std::vector<Step> second;
+
+    if (high < low) {
+        return;
+    }
+    collect(low, high, first);
+    while (true) {  // two equal passes saw the same links and flags at the moment between them
+        collect(low, high, second);
+
+        bool same = (first.size() == second.size()) && first[0].present;
+
+        for (size_t i = 0; same && (i < first.size()); ++i) {
+            same = (first[i].node == second[i].node) && (first[i].version == second[i].version) &&
+                   (first[i].present == second[i].present);
+        }
+        if (same) {
+            break;
+        }
+        std::swap(first, second);
+    }
+    for (const Step& step : first) {
+        if ((step.node != nullptr) && (step.node != head) && step.present &&
+            !(step.node->value < low) && !(high < step.node->value)) {
+            fn(step.node->value);
+        }
+    }
+}
+
+template<typename type>
+bool ConcurrentSkipList<type>::isClear() const {
+    return size.load(std::memory_order_relaxed) == 0;
+}
+
+template<typename type>
+void ConcurrentSkipList<type>::clear() {
+    SkipNode<type>* node = head->next[0].load(std::memory_order_relaxed);
+
+    while (node != nullptr) {
+        SkipNode<type>* next = node->next[0].load(std::memory_order_relaxed);
+
+        delete node;
+        node = next;
+    }
+    for (std::atomic<SkipNode<type>*>& list : retired) {
+        freeList(list.exchange(nullptr, std::memory_order_acquire));
+    }
+    for (int64_t level = 0; level < max_height; ++level) {
+        head->next[level].store(nullptr, std::memory_order_relaxed);
+    }
+    head->version.fetch_add(1, std::memory_order_relaxed);
+    size.store(0, std::memory_order_relaxed);
+}
+
+template<typename type>
+int64_t ConcurrentSkipList<type>::getSize() const {
+    return size.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,418 @@
+// Copyright 2023 binoll
+#pragma once
+
+#include "../libs.hpp"
+#include "priority_queue.hpp"
+
+// Max-priority queue that can hold more elements than fit in memory. New
+// elements go to an in-memory insertion heap; when it fills its half of the
+// memory budget it is sorted in place and written out as one run to a
+// temporary file with large sequential writes. popMax takes the best of the
+// insertion heap and the heads of the runs, reading every run block by block,
+// so the runs are merged lazily. The other half of the budget holds the read
+// buffers and gives the fan-in, the number of blocks that fit in it. A new run
+// is on level 0, and as soon as a level has fan-in runs they are merged into
+// one run on the next level, so every element is written once per level and
+// there are only log(n / heap) / log(fan-in) levels. A merge stages its output
+// in the empty insertion heap and can be undone by seeking back to the heads,
+// so it needs no memory beyond the budget. The block is shrunk to a
+// quarter of the budget if needed, so the fan-in is at least 2, and when many
+// runs are alive they share the read half with smaller reads. type must be
+// trivially copyable.
+template<typename type>
+class ExternalPriorityQueue {
+ public:
+    explicit ExternalPriorityQueue(const int64_t& memory_budget,
+                                   const int64_t& block_size = 1 << 20);  // constructor, sizes in bytes
+
+    ExternalPriorityQueue(const ExternalPriorityQueue<type>& queue) = delete;
+
+    ExternalPriorityQueue<type>& operator=(const ExternalPriorityQueue<type>& queue) = delete;
+
+    ~ExternalPriorityQueue();  // destructor, removes the temporary files
+
+    void push(const type& value, const int64_t& priority);  // push element
+
+    QueueNode<type> popMax();  // pop element with max priority
+
+    QueueNode<type> findMax() const;  // find element with max priority
+
+    void clear();  // clear queue
+
+    bool isClear() const;  // checking for emptiness
+
+    int64_t getSize() const;  // return size of the queue
+
+    int64_t getRunCount() const;  // return number of runs on disk
+
+    int64_t getFanIn() const;  // return max number of runs merged at once
+
+    int64_t getWrittenBytes() const;  // return number of bytes written to disk
+
+    int64_t getReadBytes() const;  // return number of bytes read from disk
+
+ private:
+    static_assert(std::is_trivially_copyable<type>::value,
+                  "ExternalPriorityQueue stores values as raw bytes");
+
+    struct Record {
+        int64_t priority;  // priority of the element
+        type value;  // value of the element
+    };
+
+    struct Run {
+        std::FILE* file = nullptr;  // temporary file with records in descending order
+        std::vector<Record> buffer;  // block of records read from the file
+        int64_t position = 0;  // next record in buffer
+        int64_t remaining = 0;  // records left in the file after buffer
+        int64_t level = 0;  // number of merges behind the run
+    };
+
+    static bool lower(const Record& a, const Record& b);  // order of the insertion heap
+
+    static bool higher(const Record& a, const Record& b);  // order of the records in a run
+
+    void spill();  // write the insertion heap to a new run, the heap is kept if it fails
+
+    void writeBlock(Run& run, const Record* records, const int64_t& count);  // append records to the file of run
+
+    void finishWrite(Run& run);  // flush the file of run and rewind it for reading
+
+    bool refill(Run& run);  // read the next block of run, false if run is exhausted
+
+    bool step(Run& run);  // move past the head of run, false if run is exhausted
+
+    void advance(const int64_t& index);  // drop the head of run index
+
+    void merge(const int64_t& level);  // merge fan-in runs of level into one run of the next level, no change if it fails
+
+    void removeExhausted();  // forget closed runs and rebuild heads
+
+    void closeRuns();  // close and forget all runs
+
+    std::vector<Record> heap;  // elements not yet written to disk, a heap by lower
+    std::vector<std::unique_ptr<Run>> runs;  // runs on disk
+    PriorityQueue<int64_t> heads;  // run indices by the priority of their head
+    int64_t heap_capacity = 0;  // max number of elements in heap
+    int64_t block_records = 0;  // number of records in one block
+    int64_t buffer_records = 0;  // number of records in all read buffers together
+    int64_t fan_in = 0;  // runs of one level merged at once
+    int64_t size = 0;  // current size of the queue
+    int64_t written_bytes = 0;  // bytes written to disk
+    int64_t read_bytes = 0;  // bytes read from disk
+};
+
+template<typename type>
+ExternalPriorityQueue<type>::ExternalPriorityQueue(const int64_t& memory_budget,
+                                                   const int64_t& block_size) {
+    int64_t record = static_cast<int64_t>(sizeof(Record));
+    int64_t half = std::max(record, memory_budget / 2);
+
+    block_records = std::max<int64_t>(1, std::min(block_size, half / 2) / record);
+    heap_capacity = std::max<int64_t>(1, half / record);
+    buffer_records = std::max(2 * block_records, half / record);
+    fan_in = buffer_records / block_records;
+    try {
+        heap.reserve(heap_capacity);
+    } catch (...) {
+        std::cout << "\nProblems with constructor\n";
+    }
+}
+
+template<typename type>
+ExternalPriorityQueue<type>::~ExternalPriorityQueue() {
+    closeRuns();
+}
+
+template<typename type>
+bool ExternalPriorityQueue<type>::lower(const Record& a, const Record& b) {
+    return a.priority < b.priority;
+}
+
+template<typename type>
+bool ExternalPriorityQueue<type>::higher(const Record& a, const Record& b) {
+    return a.priority > b.priority;
+}
+
+template<typename type>
+void ExternalPriorityQueue<type>::closeRuns() {
+    for (auto& run : runs) {
+        if (run->file != nullptr) {
+            std::fclose(run->file);  // tmpfile deletes itself on close
+        }
+    }
+    runs.clear();
+    heads.clear();
+}
+
+template<typename type>
+void ExternalPriorityQueue<type>::writeBlock(Run& run, const Record* records, const int64_t& count) {
+    if (count == 0) {
+        return;
+    }
+    if (std::fwrite(records, sizeof(Record), count, run.file) != static_cast<size_t>(count)) {
+        throw std::runtime_error("write failed");
+    }
+    written_bytes += count * static_cast<int64_t>(sizeof(Record));
+    run.remaining += count;
+}
+
+template<typename type>
+void ExternalPriorityQueue<type>::finishWrite(Run& run) {
+    if (std::fflush(run.file) != 0) {  // buffered writes fail only here
+        throw std::runtime_error("write failed");
+    }
+    std::rewind(run.file);
+}
+
+template<typename type>
+bool ExternalPriorityQueue<type>::refill(Run& run) {
+    // alive runs share the read half of the budget, but a read is never longer than a block
+    int64_t share = buffer_records / std::max<int64_t>(1, static_cast<int64_t>(runs.size()));
+    int64_t count = std::min(run.remaining, std::max<int64_t>(1, std::min(block_records, share)));
+
+    run.buffer.resize(count);
+    run.position = 0;
+    if (count == 0) {
+        return false;
+    }
+    if (std::fread(run.buffer.data(), sizeof(Record), count, run.file) != static_cast<size_t>(count)) {
+        throw std::runtime_error("read failed");
+    }
+    read_bytes += count * static_cast<int64_t>(sizeof(Record));
+    run.remaining -= count;
+    return true;
+}
+
+template<typename type>
+bool ExternalPriorityQueue<type>::step(Run& run) {
+    return (++run.position < static_cast<int64_t>(run.buffer.size())) || refill(run);
+}
+
+template<typename type>
+void ExternalPriorityQueue<type>::spill() {
+    std::unique_ptr<Run> run(new Run());
+
+    run->file = std::tmpfile();
+    if (run->file == nullptr) {
+        throw std::runtime_error("cannot create temporary file");
+    }
+    try {  // the elements stay in heap until the whole run is on disk
+        int64_t count = static_cast<int64_t>(heap.size());
+
+        std::sort(heap.begin(), heap.end(), higher);
+        for (int64_t first = 0; first < count; first += block_records) {
+            writeBlock(*run, heap.data() + first, std::min(block_records, count - first));
+        }
+        finishWrite(*run);
+        refill(*run);
+    } catch (...) {
+        std::fclose(run->file);
+        std::make_heap(heap.begin(), heap.end(), lower);
+        throw;
+    }
+    heap.clear();
+    runs.push_back(std::move(run));
+    try {  // a failed merge changes no run, but heads must still see the new one
+        for (int64_t level = 0; ; ++level) {  // a merge can fill the next level as well
+            int64_t count = 0;
+
+            for (const auto& ptr : runs) {
+                count += ((ptr->file != nullptr) && (ptr->level == level)) ? 1 : 0;
+            }
+            if (count < fan_in) {
+                break;
+            }
+            merge(level);
+        }
+    } catch (...) {
+        removeExhausted();
+        throw;
+    }
+    removeExhausted();
+}
+
+template<typename type>
+void ExternalPriorityQueue<type>::advance(const int64_t& index) {
+    Run& run = *runs[index];
+
+    if (!step(run)) {
+        std::fclose(run.file);
+        run.file = nullptr;
+        run.buffer = std::vector<Record>();
+        heads.popMax();
+        return;
+    }
+    heads.replaceMax(index, run.buffer[run.position].priority);
+}
+
+template<typename type>
+void ExternalPriorityQueue<type>::merge(const int64_t& level) {
+    struct Source {
+        Run* run;
+        long offset;  // file position of the head before the merge
+        int64_t remaining;  // records from the head to the end of the file
+    };
+    std::vector<Source> sources;
+    PriorityQueue<int64_t> order;  // sources by the priority of their head
+    std::unique_ptr<Run> merged(new Run());
+    std::vector<Record>& block = heap;  // empty during a merge, its reserved half of the budget holds the output
+
+    for (const auto& run : runs) {
+        if ((run->file != nullptr) && (run->level == level) && (static_cast<int64_t>(sources.size()) < fan_in)) {
+            int64_t buffered = static_cast<int64_t>(run->buffer.size()) - run->position;
+
+            order.push(static_cast<int64_t>(sources.size()), run->buffer[run->position].priority);
+            sources.push_back(Source{run.get(),
+                                     std::ftell(run->file) - static_cast<long>(buffered * sizeof(Record)),
+                                     run->remaining + buffered});
+        }
+    }
+    merged->level = level + 1;
+    merged->file = std::tmpfile();
+    if (merged->file == nullptr) {
+        throw std::runtime_error("cannot create temporary file");
+    }
+    try {  // the sources are closed only when the merged run is on disk
+        while (order.getSize() != 0) {
+            int64_t index = order.findMax().getValue();
+            Run& run = *sources[index].run;
+
+            block.push_back(run.buffer[run.position]);
+            if (static_cast<int64_t>(block.size()) == block_records) {
+                writeBlock(*merged, block.data(), block_records);
+                block.clear();
+            }
+            if (step(run)) {
+                order.replaceMax(index, run.buffer[run.position].priority);
+            } else {
+                order.popMax();
+            }
+        }
+        writeBlock(*merged, block.data(), static_cast<int64_t>(block.size()));
+        block.clear();
+        finishWrite(*merged);
+        refill(*merged);
+    } catch (...) {
+        std::fclose(merged->file);
+        block.clear();
+        for (auto& source : sources) {  // read the heads again instead of keeping copies of the buffers
+            source.run->remaining = source.remaining;
+            std::fseek(source.run->file, source.offset, SEEK_SET);
+        }
+        for (auto& source : sources) {
+            refill(*source.run);
+        }
+        throw;
+    }
+    for (auto& source : sources) {
+        std::fclose(source.run->file);
+        source.run->file = nullptr;
+    }
+    runs.push_back(std::move(merged));
+}
+
+template<typename type>
+void ExternalPriorityQueue<type>::removeExhausted() {
+    runs.erase(std::remove_if(runs.begin(), runs.end(),
+                              [](const std::unique_ptr<Run>& run) { return run->file == nullptr; }),
+               runs.end());
+    heads.clear();
+    for (int64_t i = 0; i < static_cast<int64_t>(runs.size()); ++i) {
+        heads.push(i, runs[i]->buffer[runs[i]->position].priority);
+    }
+}
+
+template<typename type>
+void ExternalPriorityQueue<type>::push(const type& value, const int64_t& priority) {
+    try {
+        if (static_cast<int64_t>(heap.size()) == heap_capacity) {
+            spill();
+        }
+        heap.push_back(Record{priority, value});
+        std::push_heap(heap.begin(), heap.end(), lower);
+        ++size;
+    } catch (...) {
+        std::cout << "\nProblems with push method!\n";
+    }
+}
+
+template<typename type>
+QueueNode<type> ExternalPriorityQueue<type>::popMax() {
+    if (size == 0) {
+        std::cout << "\nProblems with pop method!\n";
+        return QueueNode<type>();
+    }
+    try {
+        if ((heads.getSize() == 0) ||
+            (!heap.empty() && (heap.front().priority >= heads.getMaxPriority()))) {
+            std::pop_heap(heap.begin(), heap.end(), lower);
+
+            QueueNode<type> node(heap.back().value, heap.back().priority);
+
+            heap.pop_back();
+            --size;
+            return node;
+        }
+
+        int64_t index = heads.findMax().getValue();
+        const Record& record = runs[index]->buffer[runs[index]->position];
+        QueueNode<type> node(record.value, record.priority);
+
+        advance(index);
+        --size;
+        return node;
+    } catch (...) {
+        std::cout << "\nProblems with pop method!\n";
+        return QueueNode<type>();
+    }
+}
+
+template<typename type>
+QueueNode<type> ExternalPriorityQueue<type>::findMax() const {
+    if ((heads.getSize() == 0) ||
+        (!heap.empty() && (heap.front().priority >= heads.getMaxPriority()))) {
+        return QueueNode<type>(heap.front().value, heap.front().priority);
+    }
+
+    const Run& run = *runs[heads.findMax().getValue()];
+
+    return QueueNode<type>(run.buffer[run.position].value, run.buffer[run.position].priority);
+}
+
+template<typename type>
+void ExternalPriorityQueue<type>::clear() {
+    closeRuns();
+    heap.clear();
+    size = 0;
+}
+
+template<typename type>
+bool ExternalPriorityQueue<type>::isClear() const {
+    return size == 0;
+}
+
+template<typename type>
+int64_t ExternalPriorityQueue<type>::getSize() const {
+    return size;
+}
+
+template<typename type>
+int64_t ExternalPriorityQueue<type>::getRunCount() const {
+    return heads.getSize();
+}
+
+template<typename type>
+int64_t ExternalPriorityQueue<type>::getFanIn() const {
+    return fan_in;
+}
+
+template<typename type>
+int64_t ExternalPriorityQueue<type>::getWrittenBytes() const {
+    return written_bytes;
+}
+
+template<typename type>
+int64_t ExternalPriorityQueue<type>::getReadBytes() const {
+    return read_bytes;
+}
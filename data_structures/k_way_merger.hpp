@@ -0,0 +1,140 @@
+// Copyright 2023 binoll
+#pragma once
+
+#include "../libs.hpp"
+
+// Merges N sorted input ranges into one sorted output with a loser tree: each
+// inner node keeps the loser of the match played there and the overall winner
+// is kept separately, so producing the next element replays only the path of
+// the previous winner (about log N comparisons). Nothing is allocated after
+// construction. Equal elements come out in the order of their runs.
+template<typename iterator,
+         typename compare = std::less<typename std::iterator_traits<iterator>::value_type>>
+class KWayMerger {
+ public:
+    using value_type = typename std::iterator_traits<iterator>::value_type;  // type of merged elements
+
+    explicit KWayMerger(const std::vector<std::pair<iterator, iterator>>& runs);  // constructor from sorted runs
+
+    ~KWayMerger() = default;  // destructor
+
+    bool isClear() const;  // true when every run is exhausted
+
+    const value_type& findMin() const;  // next element of the merged output
+
+    value_type popMin();  // take next element of the merged output
+
+    template<typename output>
+    output mergeTo(output out);  // write the rest of the merged output, returns the end
+
+    int64_t getRunCount() const;  // return number of runs
+
+ private:
+    bool less(const int64_t& a, const int64_t& b) const;  // must run a go before run b
+
+    void replay(int64_t run);  // play the matches on the path of run up to the root
+
+    std::vector<std::pair<iterator, iterator>> runs;  // current position and end of every run
+    std::vector<int64_t> tree;  // tree[0] is the winner, tree[1..N-1] are losers of inner nodes
+    compare comparator;  // order of the elements
+    int64_t count = 0;  // number of runs
+};
+
+template<typename iterator, typename compare>
+KWayMerger<iterator, compare>::KWayMerger(const std::vector<std::pair<iterator, iterator>>& runs)
+    : runs(runs), count(static_cast<int64_t>(runs.size())) {
+    try {
+        if (count == 0) {
+            return;
+        }
+        tree.assign(count, 0);
+
+        std::vector<int64_t> winners(2 * count);  // winners of the matches, leaves at count..2count-1
+
+        for (int64_t i = 0; i < count; ++i) {
+            winners[count + i] = i;
+        }
+        for (int64_t i = count - 1; i > 0; --i) {
+            int64_t left = winners[2 * i];
+            int64_t right = winners[2 * i + 1];
+
+            if (less(right, left)) {
+                winners[i] = right;
+                tree[i] = left;
+            } else {
+                winners[i] = left;
+                tree[i] = right;
+            }
+        }
+        tree[0] = (count == 1) ? 0 : winners[1];
+    } catch (...) {
+        count = 0;
+        std::cout << "\nProblems with constructor\n";
+    }
+}
+
+template<typename iterator, typename compare>
+bool KWayMerger<iterator, compare>::less(const int64_t& a, const int64_t& b) const {
+    if (runs[a].first == runs[a].second) {  // an exhausted run loses every match
+        return false;
+    }
+    if (runs[b].first == runs[b].second) {
+        return true;
+    }
+    if (comparator(*runs[a].first, *runs[b].first)) {
+        return true;
+    }
+    if (comparator(*runs[b].first, *runs[a].first)) {
+        return false;
+    }
+    return a < b;
+}
+
+template<typename iterator, typename compare>
+void KWayMerger<iterator, compare>::replay(int64_t run) {
+    for (int64_t i = (count + run) / 2; i > 0; i /= 2) {
+        if (less(tree[i], run)) {
+            std::swap(tree[i], run);
+        }
+    }
+    tree[0] = run;
+}
+
+template<typename iterator, typename compare>
+bool KWayMerger<iterator, compare>::isClear() const {
+    return (count == 0) || (runs[tree[0]].first == runs[tree[0]].second);
+}
+
+template<typename iterator, typename compare>
+const typename KWayMerger<iterator, compare>::value_type& KWayMerger<iterator, compare>::findMin() const {
+    return *runs[tree[0]].first;
+}
+
+template<typename iterator, typename compare>
+typename KWayMerger<iterator, compare>::value_type KWayMerger<iterator, compare>::popMin() {
+    int64_t run = tree[0];
+    value_type value = *runs[run].first;
+
+    ++runs[run].first;
+    replay(run);
+    return value;
+}
+
+template<typename iterator, typename compare>
+template<typename output>
+output KWayMerger<iterator, compare>::mergeTo(output out) {
+    while (!isClear()) {
+        int64_t run = tree[0];
+
+        *out = *runs[run].first;
+        ++out;
+        ++runs[run].first;
+        replay(run);
+    }
+    return out;
+}
+
+template<typename iterator, typename compare>
+int64_t KWayMerger<iterator, compare>::getRunCount() const {
+    return count;
+}
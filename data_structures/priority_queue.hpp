@@ -11,6 +11,9 @@ class QueueNode {
     explicit QueueNode(const type& value,
                        const int64_t& priority);  // constructor with parameters
 
+    explicit QueueNode(type&& value,
+                       const int64_t& priority);  // constructor with parameters, takes the value
+
     ~QueueNode() = default;  // destructor
 
     type getValue() const;  // get value
@@ -28,25 +31,52 @@ class QueueNode {
     int64_t priority = 0;  // node priority
 };
 
-template<typename type>
+// Heap ordered by compare on the priorities: popMax returns the element whose
+// priority is the greatest according to compare (std::less gives a max-heap,
+// std::greater a min-heap). In stable mode elements with equal priorities
+// leave popMax in insertion (FIFO) order.
+template<typename type, typename compare = std::less<int64_t>, bool stable = false>
 class PriorityQueue {
  public:
     PriorityQueue() = default;  // constructor without parameters
 
     PriorityQueue(const type& value, const int64_t& priority);  // constructor with parameters
 
-    PriorityQueue(const PriorityQueue<type>& queue);  // copy constructor
+    PriorityQueue(const type* arr_value, const int64_t* arr_priority,
+                  const int64_t& count);  // bulk constructor from arrays, O(n)
+
+    template<typename iterator,
+             typename = typename std::iterator_traits<iterator>::iterator_category>
+    PriorityQueue(iterator first, iterator last);  // bulk constructor from a range of QueueNode, O(n)
 
-    PriorityQueue(PriorityQueue<type>&& queue) noexcept;  // move constructor
+    PriorityQueue(const PriorityQueue<type, compare, stable>& queue);  // copy constructor
+
+    PriorityQueue(PriorityQueue<type, compare, stable>&& queue) noexcept;  // move constructor
 
     ~PriorityQueue();  // destructor
 
     void push(const type& value, const int64_t& priority);  // push element
 
+    void assign(const type* arr_value, const int64_t* arr_priority,
+                const int64_t& count);  // replace content with arrays, O(n)
+
+    template<typename iterator>
+    void assign(iterator first, iterator last);  // replace content with a range of QueueNode, O(n)
+
+    void pushBatch(const type* arr_value, const int64_t* arr_priority,
+                   const int64_t& count);  // push several elements at once
+
+    template<typename iterator>
+    void pushBatch(iterator first, iterator last);  // push a range of QueueNode at once
+
     QueueNode<type> popMax();  //pop element with max priority
 
     QueueNode<type> popMin();  //pop element with min priority
 
+    void replaceMax(const type& value, const int64_t& priority);  // pop max and push element with one sift
+
+    void reserve(const int64_t& new_capacity);  // grow the storage without changing the content
+
     void clear();  // clear queue
 
     int64_t getSize() const;  // return size of the queue
@@ -55,28 +85,71 @@ class PriorityQueue {
 
     QueueNode<type> findMin() const;  // find element with max priority
 
-    PriorityQueue<type>& operator=(const PriorityQueue<type>& queue);  // for assignment
+    int64_t getMaxPriority() const;  // priority of the element with max priority, without copying it
 
-    PriorityQueue<type>& operator=(PriorityQueue<type>&& queue) noexcept;  // for assignment with carry
+    PriorityQueue<type, compare, stable>& operator=(const PriorityQueue<type, compare, stable>& queue);  // for assignment
 
-    template<typename new_type>
+    PriorityQueue<type, compare, stable>& operator=(PriorityQueue<type, compare, stable>&& queue) noexcept;  // for assignment with carry
+
+    template<typename new_type, typename new_compare, bool new_stable>
     friend std::ostream& operator<<(std::ostream& stream,
-                                    const PriorityQueue<new_type>& queue);  // for print
+                                    const PriorityQueue<new_type, new_compare, new_stable>& queue);  // for print
 
  private:
-    void siftUp();  // for sift up
+    void siftUp(int64_t index);  // for sift up
+
+    void siftDown(int64_t index);  // for sift down
+
+    void heapify();  // bottom-up (Floyd) heap construction, O(n)
+
+    void finishBatch(const int64_t& first, const int64_t& count);  // restore the heap after appending
+
+    void copyFrom(const PriorityQueue<type, compare, stable>& queue);  // copy the content of another queue
+
+    int64_t minLeaf() const;  // index of the element with min priority
+
+    struct StableKey {
+        int64_t priority;  // priority of the element
+        uint64_t sequence;  // insertion number of the element
+    };
+
+    using key_type = typename std::conditional<stable, StableKey, int64_t>::type;  // what the heap compares
+
+    bool higher(const int64_t& a, const int64_t& b) const;  // must a be above b
+
+    bool higher(const StableKey& a, const StableKey& b) const;  // must a be above b, ties by insertion
 
-    void siftDown();  // for sift down
+    static int64_t priorityOf(const int64_t& key);  // priority stored in a key
 
-    int64_t size = 0;  // current capacity of the queue
+    static int64_t priorityOf(const StableKey& key);  // priority stored in a key
+
+    void makeKey(int64_t& key, const int64_t& priority);  // key for a new element
+
+    void makeKey(StableKey& key, const int64_t& priority);  // key for a new element, takes an insertion number
+
+    void append(const type& value, const int64_t& priority);  // put element at the end without sifting
+
+    void moveElement(const int64_t& to, const int64_t& from);  // move element between slots
+
+    // keys and values are parallel arrays: the sift loops compare only the
+    // dense keys and move each payload once per level instead of swapping it
+    int64_t size = 0;  // current size of the queue
+    int64_t capacity = 0;  // number of allocated elements
     int64_t max_size = std::numeric_limits<int64_t>::max();  // maximum value
-    QueueNode<type>* arr = nullptr;  // indicates the array in which the elements of the queue are stored
+    key_type* keys = nullptr;  // priorities (with insertion numbers in stable mode) in heap order
+    type* values = nullptr;  // values of the elements, parallel to keys
+    uint64_t counter = 0;  // next insertion number, stable mode only
+    compare comparator;  // order of the priorities
 };
 
 template<typename type>
 QueueNode<type>::QueueNode(const type &value,
                            const int64_t &priority) : value(value), priority(priority) {}
 
+template<typename type>
+QueueNode<type>::QueueNode(type&& value,
+                           const int64_t& priority) : value(std::move(value)), priority(priority) {}
+
 template<typename type>
 type QueueNode<type>::getValue() const {
     return value;
@@ -99,103 +172,251 @@ std::ostream& operator<<(std::ostream& stream,
     return stream;
 }
 
-template<typename type>
-PriorityQueue<type>::PriorityQueue(const type& value, const int64_t& priority) {
+template<typename type, typename compare, bool stable>
+PriorityQueue<type, compare, stable>::PriorityQueue(const type& value, const int64_t& priority) {
     try {
-        arr = new QueueNode<type>[++size];
-        arr[size - 1] = QueueNode<type>(value, priority);
+        reserve(1);
+        append(value, priority);
     } catch (...) {
         std::cout << "\nProblems with constructor\n";
     }
 }
 
-template<typename type>
-PriorityQueue<type>::PriorityQueue(const PriorityQueue<type>& queue) {
-    try {
-        this->size = queue.size;
+template<typename type, typename compare, bool stable>
+PriorityQueue<type, compare, stable>::PriorityQueue(const type* arr_value,
+                                                    const int64_t* arr_priority,
+                                                    const int64_t& count) {
+    assign(arr_value, arr_priority, count);
+}
 
-        if (queue.size == 0) {
-            delete[] arr;
-            arr = nullptr;
-        } else {
-            delete[] arr;
-            arr = new type[size];
+template<typename type, typename compare, bool stable>
+template<typename iterator, typename>
+PriorityQueue<type, compare, stable>::PriorityQueue(iterator first, iterator last) {
+    assign(first, last);
+}
 
-            for (int64_t i = 0; i < size; ++i) {
-                arr[i] = queue.arr[i];
-            }
-        }
+template<typename type, typename compare, bool stable>
+PriorityQueue<type, compare, stable>::PriorityQueue(const PriorityQueue<type, compare, stable>& queue)
+    : comparator(queue.comparator) {
+    try {
+        copyFrom(queue);
     } catch (...) {
         std::cout << "\nProblems with copy constructor\n";
     }
 }
 
-template<typename type>
-PriorityQueue<type>::PriorityQueue(PriorityQueue<type> &&queue) noexcept {
+template<typename type, typename compare, bool stable>
+PriorityQueue<type, compare, stable>::PriorityQueue(PriorityQueue<type, compare, stable>&& queue) noexcept
+    : comparator(std::move(queue.comparator)) {
     if (this != &queue) {
-        arr = queue.arr;
+        keys = queue.keys;
+        values = queue.values;
         size = queue.size;
-        queue.arr = nullptr;
-        queue.size = NULL;
+        capacity = queue.capacity;
+        counter = queue.counter;
+        queue.keys = nullptr;
+        queue.values = nullptr;
+        queue.size = 0;
+        queue.capacity = 0;
     }
 }
 
-template<typename type>
-PriorityQueue<type>::~PriorityQueue<type>() {
+template<typename type, typename compare, bool stable>
+PriorityQueue<type, compare, stable>::~PriorityQueue() {
     try {
-        delete[] arr;
-        arr = nullptr;
+        delete[] keys;
+        delete[] values;
+        keys = nullptr;
+        values = nullptr;
         size = 0;
+        capacity = 0;
     } catch (...) {
         std::cout << "\nProblems with destructor!\n";
     }
 }
 
-template<typename type>
-void PriorityQueue<type>::siftUp() {
-    int64_t index = size - 1;
+template<typename type, typename compare, bool stable>
+bool PriorityQueue<type, compare, stable>::higher(const int64_t& a, const int64_t& b) const {
+    return comparator(b, a);
+}
+
+template<typename type, typename compare, bool stable>
+bool PriorityQueue<type, compare, stable>::higher(const StableKey& a, const StableKey& b) const {
+    // ties go to the earlier element
+    return comparator(b.priority, a.priority) ||
+           (!comparator(a.priority, b.priority) && (a.sequence < b.sequence));
+}
 
-    while (arr[index].getPriority() > arr[(index - 1) / 2].getPriority()) {
-        std::swap(arr[index], arr[(index - 1) / 2]);
-        index = (index - 1) / 2;
+template<typename type, typename compare, bool stable>
+int64_t PriorityQueue<type, compare, stable>::priorityOf(const int64_t& key) {
+    return key;
+}
+
+template<typename type, typename compare, bool stable>
+int64_t PriorityQueue<type, compare, stable>::priorityOf(const StableKey& key) {
+    return key.priority;
+}
+
+template<typename type, typename compare, bool stable>
+void PriorityQueue<type, compare, stable>::makeKey(int64_t& key, const int64_t& priority) {
+    key = priority;
+}
+
+template<typename type, typename compare, bool stable>
+void PriorityQueue<type, compare, stable>::makeKey(StableKey& key, const int64_t& priority) {
+    key.priority = priority;
+    key.sequence = counter++;
+}
+
+template<typename type, typename compare, bool stable>
+void PriorityQueue<type, compare, stable>::append(const type& value, const int64_t& priority) {
+    key_type key;
+
+    makeKey(key, priority);
+    keys[size] = key;
+    values[size] = value;
+    ++size;
+}
+
+template<typename type, typename compare, bool stable>
+void PriorityQueue<type, compare, stable>::moveElement(const int64_t& to, const int64_t& from) {
+    keys[to] = keys[from];
+    values[to] = std::move(values[from]);
+}
+
+template<typename type, typename compare, bool stable>
+void PriorityQueue<type, compare, stable>::siftUp(int64_t index) {
+    key_type key = keys[index];
+
+    if ((index == 0) || !higher(key, keys[(index - 1) / 2])) {
+        return;
+    }
+
+    type value = std::move(values[index]);
+
+    while ((index > 0) && higher(key, keys[(index - 1) / 2])) {
+        int64_t parent = (index - 1) / 2;
+
+        moveElement(index, parent);
+        index = parent;
     }
+    keys[index] = key;
+    values[index] = std::move(value);
 }
 
-template<typename type>
-void PriorityQueue<type>::siftDown() {
-    int64_t index = 0;
+template<typename type, typename compare, bool stable>
+void PriorityQueue<type, compare, stable>::siftDown(int64_t index) {
+    key_type key = keys[index];
+    int64_t child = 2 * index + 1;
 
-    while ((2 * index + 1) < size) {
-        int64_t left = 2 * index + 1;
-        int64_t right = 2 * index + 2;
-        int64_t temp = left;
+    if (child >= size) {
+        return;
+    }
+    if ((child + 1 < size) && higher(keys[child + 1], keys[child])) {
+        ++child;
+    }
+    if (!higher(keys[child], key)) {  // the payload leaves its slot only if it really moves
+        return;
+    }
+
+    type value = std::move(values[index]);
 
-        if ((right < size) && (arr[right].getPriority() > arr[left].getPriority())) {
-            temp = right;
-        } else if (arr[index].getPriority() >= arr[temp].getPriority()) {
+    do {
+        moveElement(index, child);
+        index = child;
+        child = 2 * index + 1;
+        if (child >= size) {
             break;
         }
-        std::swap(arr[index], arr[temp]);
-        index = temp;
+        if ((child + 1 < size) && higher(keys[child + 1], keys[child])) {
+            ++child;
+        }
+    } while (higher(keys[child], key));
+    keys[index] = key;
+    values[index] = std::move(value);
+}
+
+template<typename type, typename compare, bool stable>
+void PriorityQueue<type, compare, stable>::heapify() {
+    for (int64_t i = size / 2 - 1; i >= 0; --i) {
+        siftDown(i);
     }
 }
 
-template<typename type>
-void PriorityQueue<type>::push(const type& value, const int64_t& priority) {
+template<typename type, typename compare, bool stable>
+void PriorityQueue<type, compare, stable>::reserve(const int64_t& new_capacity) {
+    if (new_capacity <= capacity) {
+        return;
+    }
+
+    std::unique_ptr<key_type[]> new_keys(new key_type[new_capacity]);
+    std::unique_ptr<type[]> new_values(new type[new_capacity]);
+
+    for (int64_t i = 0; i < size; ++i) {
+        new_keys[i] = keys[i];
+        new_values[i] = std::move(values[i]);
+    }
+    delete[] keys;
+    delete[] values;
+    keys = new_keys.release();
+    values = new_values.release();
+    capacity = new_capacity;
+}
+
+template<typename type, typename compare, bool stable>
+void PriorityQueue<type, compare, stable>::finishBatch(const int64_t& first, const int64_t& count) {
+    int64_t levels = 1;
+
+    for (int64_t i = size; i > 1; i /= 2) {
+        ++levels;
+    }
+    // sifting every new element up costs about count * log(size) comparisons,
+    // rebuilding the whole heap costs about 2 * size
+    if (count * levels > 2 * size) {
+        heapify();
+    } else {
+        for (int64_t i = first; i < size; ++i) {
+            siftUp(i);
+        }
+    }
+}
+
+template<typename type, typename compare, bool stable>
+void PriorityQueue<type, compare, stable>::copyFrom(const PriorityQueue<type, compare, stable>& queue) {
+    size = 0;
+    reserve(queue.size);
+    for (int64_t i = 0; i < queue.size; ++i) {
+        keys[i] = queue.keys[i];
+        values[i] = queue.values[i];
+    }
+    size = queue.size;
+    counter = queue.counter;
+}
+
+template<typename type, typename compare, bool stable>
+int64_t PriorityQueue<type, compare, stable>::minLeaf() const {
+    int64_t index = size / 2;  // the minimum of a heap is always a leaf
+
+    for (int64_t i = index + 1; i < size; ++i) {
+        if (higher(keys[index], keys[i])) {
+            index = i;
+        }
+    }
+    return index;
+}
+
+template<typename type, typename compare, bool stable>
+void PriorityQueue<type, compare, stable>::push(const type& value, const int64_t& priority) {
     if (size == max_size) {
         std::cout << "\nProblems with push method!\n";
         return;
     }
     try {
-        QueueNode<type>* new_arr = new QueueNode<type>[++size];
-
-        for (int i = 0; i < (size - 1); ++i) {
-            new_arr[i] = arr[i];
+        if (size == capacity) {
+            reserve((capacity == 0) ? 1 : 2 * capacity);
         }
-        new_arr[size - 1] = QueueNode<type>(value, priority);
-        delete[] arr;
-        arr = new_arr;
-        siftUp();
+        append(value, priority);
+        siftUp(size - 1);
         return;
     } catch (...) {
         std::cout << "\nProblems with push method!\n";
@@ -203,141 +424,156 @@ void PriorityQueue<type>::push(const type& value, const int64_t& priority) {
     }
 }
 
-template<typename type>
-QueueNode<type> PriorityQueue<type>::popMax() {
-    if (size == 0) {
-        std::cout << "\nProblems with pop method!\n";
-        return QueueNode<type>(0, 0);
-    }
+template<typename type, typename compare, bool stable>
+void PriorityQueue<type, compare, stable>::assign(const type* arr_value, const int64_t* arr_priority,
+                                                  const int64_t& count) {
     try {
-        QueueNode<type>* new_ptr = new QueueNode<type>[--size];
-        QueueNode<type> node = arr[0];
+        size = 0;
+        reserve(count);
+        for (int64_t i = 0; i < count; ++i) {
+            append(arr_value[i], arr_priority[i]);
+        }
+        heapify();
+    } catch (...) {
+        std::cout << "\nProblems with assign method!\n";
+    }
+}
 
-        std::swap(arr[0], arr[size]);
-        for (int i = 0; i < size; ++i) {
-            new_ptr[i] = arr[i];
+template<typename type, typename compare, bool stable>
+template<typename iterator>
+void PriorityQueue<type, compare, stable>::assign(iterator first, iterator last) {
+    try {
+        size = 0;
+        reserve(std::distance(first, last));
+        for (; first != last; ++first) {
+            append(first->getValue(), first->getPriority());
         }
-        delete[] arr;
-        arr = new_ptr;
-        siftUp();
-        siftDown();
-        return node;
+        heapify();
     } catch (...) {
-        std::cout << "\nProblems with pop method\n";
-        return QueueNode<type>(0, 0);
+        std::cout << "\nProblems with assign method!\n";
     }
 }
 
-template<typename type>
-QueueNode<type> PriorityQueue<type>::popMin() {
-    QueueNode<type> node = arr[0];
-    int64_t size_before = 0;
-    int64_t size_after = 0;
+template<typename type, typename compare, bool stable>
+void PriorityQueue<type, compare, stable>::pushBatch(const type* arr_value, const int64_t* arr_priority,
+                                                     const int64_t& count) {
+    if (count > max_size - size) {
+        std::cout << "\nProblems with pushBatch method!\n";
+        return;
+    }
+    try {
+        int64_t first = size;
 
-    for (int64_t i = 0; i < size; ++i) {
-        if (node.getPriority() > arr[i].getPriority()) {
-            node = arr[i];
-            size_before = i;
-            size_after = size - (i + 1);
+        if (size + count > capacity) {
+            reserve(std::max(size + count, 2 * capacity));
+        }
+        for (int64_t i = 0; i < count; ++i) {
+            append(arr_value[i], arr_priority[i]);
         }
+        finishBatch(first, count);
+    } catch (...) {
+        std::cout << "\nProblems with pushBatch method!\n";
     }
+}
 
-    try {
-        if (size == 1) {
-            --size;
-            delete[] arr;
-            arr = nullptr;
-        } else if (size_before == 0) {
-            QueueNode<type>* arr_after = new QueueNode<type>[size_after];
-
-            for (int64_t i = 0, count = (size_before + 1); count < size; ++count, ++i) {
-                arr_after[i] = arr[count];
-            }
+template<typename type, typename compare, bool stable>
+template<typename iterator>
+void PriorityQueue<type, compare, stable>::pushBatch(iterator first, iterator last) {
+    int64_t count = std::distance(first, last);
 
-            --size;
-            delete[] arr;
-            arr = new QueueNode<type>[size];
+    if (count > max_size - size) {
+        std::cout << "\nProblems with pushBatch method!\n";
+        return;
+    }
+    try {
+        int64_t begin = size;
 
-            for (int64_t i = 0, count = size_before; i < size_after; ++count, ++i) {
-                arr[count] = arr_after[i];
-            }
-            delete[] arr_after;
-        } else if (size_after == 0) {
-            QueueNode<type>* arr_before = new QueueNode<type>[size_before];
+        if (size + count > capacity) {
+            reserve(std::max(size + count, 2 * capacity));
+        }
+        for (; first != last; ++first) {
+            append(first->getValue(), first->getPriority());
+        }
+        finishBatch(begin, count);
+    } catch (...) {
+        std::cout << "\nProblems with pushBatch method!\n";
+    }
+}
 
-            for (int64_t count = 0; count < size_before; ++count) {
-                arr_before[count] = arr[count];
-            }
+template<typename type, typename compare, bool stable>
+QueueNode<type> PriorityQueue<type, compare, stable>::popMax() {
+    if (size == 0) {
+        std::cout << "\nProblems with pop method!\n";
+        return QueueNode<type>();
+    }
 
-            --size;
-            delete[] arr;
-            arr = new QueueNode<type>[size];
+    QueueNode<type> node(std::move(values[0]), priorityOf(keys[0]));
 
-            for (int64_t count = 0; count < size_before; ++count) {
-                arr[count] = arr_before[count];
-            }
-            delete[] arr_before;
-        } else {
-            QueueNode<type> *ptr_before = new QueueNode<type>[size_before];
-            QueueNode<type> *ptr_after = new QueueNode<type>[size_after];
+    if (--size > 0) {
+        moveElement(0, size);
+        siftDown(0);
+    }
+    return node;
+}
 
-            for (int64_t count = 0; count < size_before; ++count) {
-                ptr_before[count] = arr[count];
-            }
-            for (int64_t i = 0, count = (size_before + 1); count < size; ++count, ++i) {
-                ptr_after[i] = arr[count];
-            }
+template<typename type, typename compare, bool stable>
+QueueNode<type> PriorityQueue<type, compare, stable>::popMin() {
+    if (size == 0) {
+        std::cout << "\nProblems with pop method!\n";
+        return QueueNode<type>();
+    }
 
-            --size;
-            delete[] arr;
-            arr = new QueueNode<type>[size];
+    int64_t index = minLeaf();
+    QueueNode<type> node(std::move(values[index]), priorityOf(keys[index]));
 
-            for (int64_t count = 0; count < size_before; ++count) {
-                arr[count] = ptr_before[count];
-            }
-            for (int64_t i = 0, count = size_before; i < size_after; ++count, ++i) {
-                arr[count] = ptr_after[i];
-            }
-            delete[] ptr_before;
-            delete[] ptr_after;
-            siftUp();
-            siftDown();
-        }
-    } catch (...) {
-        std::cout << "\nProblems with remove element\n";
-        return QueueNode<type>(0, 0);
+    if (index < --size) {
+        moveElement(index, size);
+        siftUp(index);
     }
     return node;
 }
 
-template<typename type>
-void PriorityQueue<type>::clear() {
+template<typename type, typename compare, bool stable>
+void PriorityQueue<type, compare, stable>::replaceMax(const type& value, const int64_t& priority) {
+    if (size == 0) {
+        push(value, priority);
+        return;
+    }
+
+    key_type key;
+
+    makeKey(key, priority);
+    keys[0] = key;
+    values[0] = value;
+    siftDown(0);
+}
+
+template<typename type, typename compare, bool stable>
+void PriorityQueue<type, compare, stable>::clear() {
     try {
-        delete[] arr;
-        arr = nullptr;
+        delete[] keys;
+        delete[] values;
+        keys = nullptr;
+        values = nullptr;
         size = 0;
+        capacity = 0;
     } catch (...) {
         std::cout << "\nProblems with clear method!\n";
     }
 }
 
-template<typename type>
-int64_t PriorityQueue<type>::getSize() const {
+template<typename type, typename compare, bool stable>
+int64_t PriorityQueue<type, compare, stable>::getSize() const {
     return size;
 }
 
-template<typename type>
-PriorityQueue<type>& PriorityQueue<type>::operator=(const PriorityQueue<type>& queue) {
+template<typename type, typename compare, bool stable>
+PriorityQueue<type, compare, stable>&
+PriorityQueue<type, compare, stable>::operator=(const PriorityQueue<type, compare, stable>& queue) {
     if (this != &queue) {
         try {
-            this->size = queue.size;
-
-            delete[] arr;
-            arr = new type[size];
-
-            for (int64_t i = 0; i < size; ++i) {
-                arr[i] = queue.arr[i];
-            }
+            copyFrom(queue);
+            comparator = queue.comparator;
         } catch (...) {
             std::cout << "\nProblems with constructor\n";
         }
@@ -345,51 +581,60 @@ PriorityQueue<type>& PriorityQueue<type>::operator=(const PriorityQueue<type>& q
     return *this;
 }
 
-template<typename type>
-PriorityQueue<type>& PriorityQueue<type>::operator=(PriorityQueue<type>&& queue) noexcept {
+template<typename type, typename compare, bool stable>
+PriorityQueue<type, compare, stable>&
+PriorityQueue<type, compare, stable>::operator=(PriorityQueue<type, compare, stable>&& queue) noexcept {
     if (this != &queue) {
-        arr = queue.arr;
+        delete[] keys;
+        delete[] values;
+        comparator = std::move(queue.comparator);
+        keys = queue.keys;
+        values = queue.values;
         size = queue.size;
-        queue.arr = nullptr;
-        queue.size = NULL;
+        capacity = queue.capacity;
+        counter = queue.counter;
+        queue.keys = nullptr;
+        queue.values = nullptr;
+        queue.size = 0;
+        queue.capacity = 0;
     }
     return *this;
 }
 
-template<typename type>
-QueueNode<type> PriorityQueue<type>::findMax() const {
-    return arr[0];
+template<typename type, typename compare, bool stable>
+QueueNode<type> PriorityQueue<type, compare, stable>::findMax() const {
+    return QueueNode<type>(values[0], priorityOf(keys[0]));
 }
 
-template<typename type>
-QueueNode<type> PriorityQueue<type>::findMin() const {
-    QueueNode<type> node = arr[0];
+template<typename type, typename compare, bool stable>
+QueueNode<type> PriorityQueue<type, compare, stable>::findMin() const {
+    int64_t index = minLeaf();
 
-    for (int64_t i = 0; i < size; ++i) {
-        if (node.getPriority() > arr[i].getPriority()) {
-            node = arr[i];
-        }
-    }
-    return node;
+    return QueueNode<type>(values[index], priorityOf(keys[index]));
 }
 
-template<typename type>
+template<typename type, typename compare, bool stable>
+int64_t PriorityQueue<type, compare, stable>::getMaxPriority() const {
+    return priorityOf(keys[0]);
+}
+
+template<typename type, typename compare, bool stable>
 std::ostream& operator<<(std::ostream& stream,
-                         const PriorityQueue<type>& queue) {
+                         const PriorityQueue<type, compare, stable>& queue) {
     int64_t count = 0;
 
     stream << "{ ";
     if (queue.size != 0) {
         for (int64_t i = 0; i < queue.size; ++i) {
             if (count == 0) {
-                stream << queue.arr[i].getValue();
+                stream << queue.values[i];
             } else {
                 stream << ", ";
-                stream << queue.arr[i].getValue();
+                stream << queue.values[i];
             }
             ++count;
         }
     }
     stream << " }";
     return stream;
-}
\ No newline at end of file
+}
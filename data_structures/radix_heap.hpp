@@ -0,0 +1,141 @@
+// Copyright 2023 binoll
+#pragma once
+
+#include "../libs.hpp"
+#include "priority_queue.hpp"
+
+// Monotone min-priority queue for integer keys: every pushed priority must be
+// at least the last popped one (Dijkstra-style workloads). An element lives in
+// the bucket given by the highest bit in which its key differs from the last
+// popped key, so each element is moved at most 64 times over its lifetime.
+template<typename type>
+class RadixHeap {
+ public:
+    RadixHeap() = default;  // constructor without parameters
+
+    ~RadixHeap() = default;  // destructor
+
+    void push(const type& value, const int64_t& priority);  // push element, priority >= last popped
+
+    QueueNode<type> popMin();  // pop element with min priority
+
+    QueueNode<type> findMin();  // find element with min priority
+
+    void clear();  // clear queue
+
+    bool isClear() const;  // checking for emptiness
+
+    int64_t getSize() const;  // return size of the queue
+
+ private:
+    static uint64_t toKey(const int64_t& priority);  // order-preserving map to unsigned
+
+    static int64_t toPriority(const uint64_t& key);  // inverse of toKey
+
+    int64_t bucketIndex(const uint64_t& key) const;  // bucket for key relative to last
+
+    void refill();  // move the minimum of the first non-empty bucket into bucket 0
+
+    std::vector<std::pair<uint64_t, type>> buckets[65];  // bucket i holds keys differing from last in bit i - 1
+    uint64_t last = 0;  // last popped key
+    int64_t size = 0;  // current size of the queue
+};
+
+template<typename type>
+uint64_t RadixHeap<type>::toKey(const int64_t& priority) {
+    return static_cast<uint64_t>(priority) ^ (static_cast<uint64_t>(1) << 63);
+}
+
+template<typename type>
+int64_t RadixHeap<type>::toPriority(const uint64_t& key) {
+    return static_cast<int64_t>(key ^ (static_cast<uint64_t>(1) << 63));
+}
+
+template<typename type>
+int64_t RadixHeap<type>::bucketIndex(const uint64_t& key) const {
+    return (key == last) ? 0 : 64 - __builtin_clzll(key ^ last);
+}
+
+template<typename type>
+void RadixHeap<type>::push(const type& value, const int64_t& priority) {
+    uint64_t key = toKey(priority);
+
+    if (key < last) {
+        std::cout << "\nProblems with push method: priority is less than last popped!\n";
+        return;
+    }
+    try {
+        buckets[bucketIndex(key)].emplace_back(key, value);
+        ++size;
+    } catch (...) {
+        std::cout << "\nProblems with push method!\n";
+    }
+}
+
+template<typename type>
+void RadixHeap<type>::refill() {
+    if (!buckets[0].empty()) {
+        return;
+    }
+
+    int64_t i = 1;
+
+    while (buckets[i].empty()) {
+        ++i;
+    }
+
+    uint64_t min = buckets[i][0].first;
+
+    for (const auto& element : buckets[i]) {
+        min = std::min(min, element.first);
+    }
+    last = min;
+    for (auto& element : buckets[i]) {  // every element lands in a lower bucket
+        buckets[bucketIndex(element.first)].push_back(std::move(element));
+    }
+    buckets[i].clear();
+}
+
+template<typename type>
+QueueNode<type> RadixHeap<type>::popMin() {
+    if (size == 0) {
+        std::cout << "\nProblems with pop method!\n";
+        return QueueNode<type>();
+    }
+    refill();
+
+    QueueNode<type> node(buckets[0].back().second, toPriority(last));
+
+    buckets[0].pop_back();
+    --size;
+    return node;
+}
+
+template<typename type>
+QueueNode<type> RadixHeap<type>::findMin() {
+    if (size == 0) {
+        std::cout << "\nProblems with find method!\n";
+        return QueueNode<type>();
+    }
+    refill();
+    return QueueNode<type>(buckets[0].back().second, toPriority(last));
+}
+
+template<typename type>
+void RadixHeap<type>::clear() {
+    for (auto& bucket : buckets) {
+        bucket.clear();
+    }
+    last = 0;
+    size = 0;
+}
+
+template<typename type>
+bool RadixHeap<type>::isClear() const {
+    return size == 0;
+}
+
+template<typename type>
+int64_t RadixHeap<type>::getSize() const {
+    return size;
+}
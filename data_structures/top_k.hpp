@@ -0,0 +1,84 @@
+// Copyright 2023 binoll
+#pragma once
+
+#include "../libs.hpp"
+#include "priority_queue.hpp"
+
+// Keeps the capacity elements with the greatest priorities of a stream. The
+// kept elements sit in a min-heap, so the worst of them is at the top and a
+// better element replaces it with a single sift.
+template<typename type>
+class TopK {
+ public:
+    explicit TopK(const int64_t& capacity);  // constructor, capacity is K
+
+    ~TopK() = default;  // destructor
+
+    bool push(const type& value, const int64_t& priority);  // offer element, true if it was kept
+
+    QueueNode<type> findMin() const;  // the worst of the kept elements
+
+    std::vector<QueueNode<type>> extract();  // kept elements, best first; empties the container
+
+    void clear();  // clear container, keeps the storage
+
+    int64_t getSize() const;  // return number of kept elements
+
+    int64_t getCapacity() const;  // return K
+
+ private:
+    PriorityQueue<type, std::greater<int64_t>> queue;  // kept elements, worst on top
+    int64_t capacity = 0;  // maximum number of kept elements
+};
+
+template<typename type>
+TopK<type>::TopK(const int64_t& capacity) : capacity(capacity) {
+    try {
+        queue.reserve(capacity);
+    } catch (...) {
+        std::cout << "\nProblems with constructor\n";
+    }
+}
+
+template<typename type>
+bool TopK<type>::push(const type& value, const int64_t& priority) {
+    if (queue.getSize() < capacity) {
+        queue.push(value, priority);
+        return true;
+    }
+    if ((capacity == 0) || (priority <= queue.getMaxPriority())) {
+        return false;
+    }
+    queue.replaceMax(value, priority);
+    return true;
+}
+
+template<typename type>
+QueueNode<type> TopK<type>::findMin() const {
+    return queue.findMax();
+}
+
+template<typename type>
+std::vector<QueueNode<type>> TopK<type>::extract() {
+    std::vector<QueueNode<type>> result(queue.getSize());
+
+    for (int64_t i = queue.getSize() - 1; i >= 0; --i) {
+        result[i] = queue.popMax();
+    }
+    return result;
+}
+
+template<typename type>
+void TopK<type>::clear() {
+    queue.assign(nullptr, nullptr, 0);  // empty, but the K reserved slots stay allocated
+}
+
+template<typename type>
+int64_t TopK<type>::getSize() const {
+    return queue.getSize();
+}
+
+template<typename type>
+int64_t TopK<type>::getCapacity() const {
+    return capacity;
+}
@@ -2,6 +2,8 @@
 #pragma once
 
 #include "../../libs.hpp"
+#include "frozen_tree.hpp"
+#include "node_pool.hpp"
 
 template<typename type>
 class Node {
@@ -16,12 +18,18 @@ class Node {
 
     ~Node() = default;  // destructor
 
-    int64_t height = 0;  // tree height
     type value = 0;  // value
-    Node<type>* left = nullptr;  // pointer to the left node
-    Node<type>* right = nullptr;  // pointer to the right node
+    int8_t height = 0;  // tree height, below 1.45 log2(n + 2); sits in the padding after value
+    NodeIndex left = no_node;  // index of the left node
+    NodeIndex right = no_node;  // index of the right node
+    uint32_t count = 1;  // number of nodes in the subtree, a pool holds less than 2^32
 };
 
+// AVL tree whose nodes live in a NodePool and link each other with 32-bit indices.
+// split hands the upper part to the other tree together with a share of the pool,
+// so trees that came out of one split must not be changed from different threads
+// at once. join and the set operations first move the nodes of the smaller tree
+// into the pool of the larger one unless the two already share a pool.
 template<typename type>
 class AVLSearchTree {
  public:
@@ -41,6 +49,23 @@ class AVLSearchTree {
 
     void remove(const type& value);  // delete element
 
+    template<typename iterator>
+    void buildFromSorted(iterator first, iterator last);  // replace content with a balanced tree of sorted range, O(n)
+
+    void merge(const AVLSearchTree<type>& tree);  // add all elements of tree, O(n + m)
+
+    void join(AVLSearchTree<type>& tree);  // append tree whose elements are not less than ours, tree becomes empty
+
+    void split(const type& key, AVLSearchTree<type>& tree);  // move elements not less than key to tree
+
+    void unite(AVLSearchTree<type>& tree, const int64_t& threads = 1);  // union like std::set_union, tree becomes empty
+
+    void intersect(AVLSearchTree<type>& tree,
+                   const int64_t& threads = 1);  // intersection like std::set_intersection, tree becomes empty
+
+    void subtract(AVLSearchTree<type>& tree,
+                  const int64_t& threads = 1);  // difference like std::set_difference, tree becomes empty
+
     void traversalNLR() const;  // tree traversal NRL
 
     void traversalLNR() const;  // tree traversal LNR
@@ -53,37 +78,86 @@ class AVLSearchTree {
 
     int64_t getSize() const;  // returns the current size of tree
 
+    type select(const int64_t& index) const;  // element with the given index in order, from 0
+
+    int64_t rank(const type& value) const;  // number of elements less than value
+
+    int64_t countInRange(const type& low, const type& high) const;  // number of elements in [low, high]
+
+    FrozenTree<type> freeze() const;  // read-only copy in Eytzinger layout for fast lookups
+
     template<typename new_type>
     friend std::ostream& operator<<(std::ostream& stream,
                                     const AVLSearchTree<new_type>& tree);  // print
 
  private:
-    int64_t getHeight(Node<type>* node) const;
+    int64_t getHeight(NodeIndex node) const;
+
+    void updateHeight(NodeIndex node);  // also updates the subtree size
+
+    int64_t countOf(NodeIndex node) const;  // number of nodes in the subtree
+
+    int64_t rankUpper(const type& value) const;  // number of elements not greater than value
+
+    NodeIndex buildBalanced(const type* values, const int64_t& count);  // balanced subtree of sorted values
+
+    void collect(std::vector<type>& values) const;  // append elements in order, without recursion
 
-    void updateHeight(Node<type>* node);
+    enum class Operation { unite, intersect, subtract };  // set operation
 
-    int64_t getBalance(Node<type>* node);
+    NodeIndex joinNodes(NodeIndex left, NodeIndex middle,
+                        NodeIndex right);  // tree of left, middle and right in this order
 
-    void swapNodes(Node<type>* node1, Node<type>* node2);
+    NodeIndex joinRight(NodeIndex left, NodeIndex middle, NodeIndex right);  // join when left is higher
 
-    void rightRotate(Node<type>* node);
+    NodeIndex joinLeft(NodeIndex left, NodeIndex middle, NodeIndex right);  // join when right is higher
 
-    void leftRotate(Node<type>* node);
+    NodeIndex joinTwo(NodeIndex left, NodeIndex right);  // join without a middle node
 
-    void balance(Node<type>* node);
+    NodeIndex detachMax(NodeIndex node, NodeIndex& max);  // cut max node off the subtree
 
-    void print_NLR(Node<type>* node) const;
+    void splitNodes(NodeIndex node, const type& key, bool inclusive,
+                    NodeIndex& left, NodeIndex& right);  // left gets values less (or equal) than key
 
-    void print_LNR(Node<type>* node) const;
+    NodeIndex setOperation(NodeIndex first, NodeIndex second, Operation operation, int64_t threads,
+                           std::vector<NodeIndex>& garbage);  // combine two subtrees, dropped subtrees go to garbage
 
-    void print_RNL(Node<type>* node) const;
+    void setOperation(AVLSearchTree<type>& tree, Operation operation,
+                      const int64_t& threads);  // combine with tree, tree becomes empty
 
-    void print_tree(const Node<type>* node, int tab, std::ostream& stream) const;
+    void sharePool(AVLSearchTree<type>& tree);  // move the nodes of the smaller tree to the pool of the other
 
-    Node<type>* root = nullptr;  // pointer to the root of the tree
+    NodeIndex copyNodes(const NodePool<Node<type>>& from, NodeIndex node);  // copy subtree from another pool to ours
+
+    void freeNodes(NodeIndex node);  // free subtree in O(n) without recursion
+
+    int64_t getBalance(NodeIndex node);
+
+    NodeIndex rightRotate(NodeIndex node);  // returns the new root of the subtree
+
+    NodeIndex leftRotate(NodeIndex node);  // returns the new root of the subtree
+
+    NodeIndex balance(NodeIndex node);  // returns the new root of the subtree
+
+    void retrace(NodeIndex* path, int64_t depth);  // fix heights bottom-up until one does not change
+
+    void print_NLR(NodeIndex node) const;
+
+    void print_LNR(NodeIndex node) const;
+
+    void print_RNL(NodeIndex node) const;
+
+    void print_tree(NodeIndex node, int tab, std::ostream& stream) const;
+
+    void destroy();  // free all nodes in O(n) without recursion
+
+    std::shared_ptr<NodePool<Node<type>>> pool = std::make_shared<NodePool<Node<type>>>();  // storage of the nodes
+    NodeIndex root = no_node;  // index of the root of the tree
     int64_t min_size = std::numeric_limits<int64_t>::min();  // min value
     int64_t max_size = std::numeric_limits<int64_t>::max();  // max value
     int64_t size = 0;  // current capacity of the tree
+    static constexpr int64_t max_height = 96;  // bound on the height of any AVL tree in memory
+    static constexpr int64_t parallel_grain = 1 << 12;  // min elements of a set operation worth a thread
 };
 
 template<typename type>
@@ -103,7 +177,7 @@ template<typename type>
 AVLSearchTree<type>::AVLSearchTree(const type& value) {
     try {
         if (min_size <= size <= max_size) {
-            root = new Node<type>(value);
+            root = pool->allocate(value);
 
             ++size;
         } else {
@@ -116,22 +190,21 @@ AVLSearchTree<type>::AVLSearchTree(const type& value) {
 
 template<typename type>
 AVLSearchTree<type>::~AVLSearchTree() {
-    while (root != nullptr) {
-        remove(root->value);
-    }
+    destroy();
 }
 
 template<typename type>
 bool AVLSearchTree<type>::find(const type& value) const {
-    Node<type>* ptr = root;
+    NodePool<Node<type>>& nodes = *pool;
+    NodeIndex ptr = root;
 
-    while (ptr != nullptr) {
-        if (ptr->value == value) {
+    while (ptr != no_node) {
+        if (nodes[ptr].value == value) {
             return true;
-        } else if (ptr->value > value) {
-            ptr = ptr->left;
+        } else if (nodes[ptr].value > value) {
+            ptr = nodes[ptr].left;
         } else {
-            ptr = ptr->right;
+            ptr = nodes[ptr].right;
         }
     }
     return false;
@@ -139,79 +212,77 @@ bool AVLSearchTree<type>::find(const type& value) const {
 
 template<typename type>
 type AVLSearchTree<type>::findMin() const {
-    Node<type>* ptr = root;
-    Node<type>* parent_ptr = root;
+    NodePool<Node<type>>& nodes = *pool;
+    NodeIndex ptr = root;
+    NodeIndex parent_ptr = root;
 
-    if (ptr == nullptr) {
+    if (ptr == no_node) {
         return NULL;
     }
-    while (ptr != nullptr) {
+    while (ptr != no_node) {
         parent_ptr = ptr;
-        ptr = ptr->left;
+        ptr = nodes[ptr].left;
     }
-    return parent_ptr->value;
+    return nodes[parent_ptr].value;
 }
 
 template<typename type>
 type AVLSearchTree<type>::findMax() const {
-    Node<type>* ptr = root;
-    Node<type>* parent_ptr = root;
+    NodePool<Node<type>>& nodes = *pool;
+    NodeIndex ptr = root;
+    NodeIndex parent_ptr = root;
 
-    if (ptr == nullptr) {
+    if (ptr == no_node) {
         return NULL;
     }
-    while (ptr != nullptr) {
+    while (ptr != no_node) {
         parent_ptr = ptr;
-        ptr = ptr->right;
+        ptr = nodes[ptr].right;
     }
-    return parent_ptr->value;
+    return nodes[parent_ptr].value;
 }
 
 template<typename type>
 void AVLSearchTree<type>::add(const type& value) {
-    Node<type>* ptr = root;
-    std::stack<Node<type>*> stack;
+    NodePool<Node<type>>& nodes = *pool;
+    NodeIndex path[max_height];  // nodes from the root to the parent of the new node
+    int64_t depth = 0;
+    NodeIndex ptr = root;
 
     try {
-        if (root == nullptr) {
+        if (root == no_node) {
             if (min_size <= size <= max_size) {
-                root = new Node<type>(value);
+                root = pool->allocate(value);
 
                 ++size;
             } else {
                 throw std::exception();
             }
             return;
-        } else {
-            stack.push(ptr);
         }
+
+        NodeIndex node = pool->allocate(value);
+        const type& key = nodes[node].value;  // value may have lived in the nodes the allocation moved
+
         while (true) {
-            if (ptr->value > value) {
-                if (ptr->left == nullptr) {
-                    ptr->left = new Node<type>(value);
+            path[depth++] = ptr;
+            ++nodes[ptr].count;  // the new node ends up in this subtree
+            if (nodes[ptr].value > key) {
+                if (nodes[ptr].left == no_node) {
+                    nodes[ptr].left = node;
                     break;
-                } else {
-                    ptr = ptr->left;
-                    stack.push(ptr);
                 }
+                ptr = nodes[ptr].left;
             } else {
-                if (ptr->right == nullptr) {
-                    ptr->right = new Node<type>(value);
+                if (nodes[ptr].right == no_node) {
+                    nodes[ptr].right = node;
                     break;
-                } else {
-                    ptr = ptr->right;
-                    stack.push(ptr);
                 }
+                ptr = nodes[ptr].right;
             }
         }
         ++size;
-        while (!stack.empty()) {  // balance
-            ptr = stack.top();
-            updateHeight(ptr);
-            balance(ptr);
-            stack.pop();
-        }
-        return;
+        retrace(path, depth);
     } catch (...)  {
         std::cout << "\nAdd method threw except\n";
     }
@@ -219,200 +290,198 @@ void AVLSearchTree<type>::add(const type& value) {
 
 template<typename type>
 void AVLSearchTree<type>::remove(const type& value) {
-    Node<type>* ptr = root;
-    Node<type>* parent_ptr = root;
-    bool is_left = true;
-    std::stack<Node<type>*> stack;
+    NodePool<Node<type>>& nodes = *pool;
+    NodeIndex path[max_height];  // nodes from the root to the parent of the removed node
+    int64_t depth = 0;
+    NodeIndex ptr = root;
+
+    while ((ptr != no_node) &&
+           (nodes[ptr].value != value)) {  // search delete element
+        path[depth++] = ptr;
+        ptr = (nodes[ptr].value > value) ? nodes[ptr].left : nodes[ptr].right;
+    }
 
-    if (root != nullptr) {
-        stack.push(root);
-    } else {
+    if (ptr == no_node) {  // if did not search delete element
         return;
     }
 
-    while ((ptr != nullptr) &&
-           (ptr->value != value)) {  // search delete element
-        parent_ptr = ptr;
-        stack.push(ptr);
+    NodeIndex removed = ptr;  // node cut out of its place, the successor if ptr has two children
+    int64_t position = depth;  // index of ptr in path when it has two children
 
-        if (ptr->value > value) {
-            is_left = true;
-            ptr = ptr->left;
-        } else {
-            is_left = false;
-            ptr = ptr->right;
+    if ((nodes[ptr].left != no_node) &&
+        (nodes[ptr].right != no_node)) {
+        path[depth++] = ptr;
+        removed = nodes[ptr].right;
+        while (nodes[removed].left != no_node) {
+            path[depth++] = removed;
+            removed = nodes[removed].left;
         }
     }
+    for (int64_t i = 0; i < depth; ++i) {
+        --nodes[path[i]].count;
+    }
 
-    if (ptr == nullptr) {  // if did not search delete element
-        return;
+    NodeIndex child = (nodes[removed].left != no_node) ? nodes[removed].left : nodes[removed].right;
+    NodeIndex parent = (depth == 0) ? no_node : path[depth - 1];
+
+    if (parent == no_node) {
+        root = child;
+    } else if (nodes[parent].left == removed) {
+        nodes[parent].left = child;
+    } else {
+        nodes[parent].right = child;
+    }
+    if (removed != ptr) {  // the successor takes the place of ptr, values are never copied
+        NodeIndex ptr_parent = (position == 0) ? no_node : path[position - 1];
+
+        nodes[removed].left = nodes[ptr].left;
+        nodes[removed].right = nodes[ptr].right;
+        nodes[removed].count = nodes[ptr].count;
+        nodes[removed].height = nodes[ptr].height;
+        if (ptr_parent == no_node) {
+            root = removed;
+        } else if (nodes[ptr_parent].left == ptr) {
+            nodes[ptr_parent].left = removed;
+        } else {
+            nodes[ptr_parent].right = removed;
+        }
+        path[position] = removed;
     }
+    nodes.deallocate(ptr);
+    --size;
+    retrace(path, depth);
+}
 
-    try {
-        if ((ptr->left == nullptr) &&
-            (ptr->right == nullptr)) {  // delete if no child
-            if (ptr == root) {
-                delete root;
-                root = nullptr;
-            } else if (is_left) {
-                delete parent_ptr->left;
-                parent_ptr->left = nullptr;
-            } else {
-                delete parent_ptr->right;
-                parent_ptr->right = nullptr;
-            }
-        } else if (ptr->right == nullptr) {  // delete if only left child
-            if (ptr == root) {
-                Node<type>* temp = root;
-
-                root = ptr->left;
-                delete temp;
-            } else if (is_left) {
-                parent_ptr->left = ptr->left;
-                delete ptr;
-            } else {
-                parent_ptr->right = ptr->left;
-                delete ptr;
-            }
-        } else if (ptr->left == nullptr) {  // delete if only right child
-            if (ptr == root) {
-                Node<type>* temp = root;
-
-                root = ptr->right;
-                delete temp;
-            } else if (is_left) {
-                parent_ptr->left = ptr->right;
-                delete ptr;
-            } else {
-                parent_ptr->right = ptr->right;
-                delete ptr;
-            }
-        } else {  // delete if two child
-            Node<type>* successor = ptr;
-            Node<type>* parent_successor = ptr;
-            Node<type>* child_successor = ptr->right;
-
-            while (child_successor != nullptr) {
-                parent_successor = successor;
-                successor = child_successor;
-                child_successor = child_successor->left;
-            }
+template<typename type>
+void AVLSearchTree<type>::retrace(NodeIndex* path, int64_t depth) {
+    NodePool<Node<type>>& nodes = *pool;
 
-            if (successor != ptr->right) {
-                parent_successor->left = successor->right;
+    while (depth > 0) {  // subtree sizes are already fixed on the way down
+        NodeIndex node = path[--depth];
+        int8_t height = nodes[node].height;
+
+        updateHeight(node);
+
+        NodeIndex top = balance(node);
+
+        if (top != node) {
+            if (depth == 0) {
+                root = top;
+            } else if (nodes[path[depth - 1]].left == node) {
+                nodes[path[depth - 1]].left = top;
             } else {
-                ptr->right = successor->right;
+                nodes[path[depth - 1]].right = top;
             }
-
-            ptr->value = successor->value;
-            delete successor;
         }
-        --size;
-
-        while (!stack.empty() && (size > 2)) {  // balance
-            ptr = stack.top();
-            updateHeight(ptr);
-            balance(ptr);
-            stack.pop();
+        if (nodes[top].height == height) {  // nodes above see the same subtree height
+            return;
         }
-    } catch (...) {
-        std::cout << "\nRemove method threw except\n";
     }
 }
 
 template<typename type>
-int64_t AVLSearchTree<type>::getHeight(Node<type>* node) const {
-    return (node == nullptr) ? -1 : node->height;
+int64_t AVLSearchTree<type>::getHeight(NodeIndex node) const {
+    return (node == no_node) ? -1 : (*pool)[node].height;
 }
 
 template<typename type>
-void AVLSearchTree<type>::updateHeight(Node<type>* node) {
-    node->height = std::max(getHeight(node->left), getHeight(node->right)) + 1;
-}
+void AVLSearchTree<type>::updateHeight(NodeIndex node) {
+    NodePool<Node<type>>& nodes = *pool;
 
+    nodes[node].height = static_cast<int8_t>(std::max(getHeight(nodes[node].left), getHeight(nodes[node].right)) + 1);
+    nodes[node].count = static_cast<uint32_t>(countOf(nodes[node].left) + countOf(nodes[node].right) + 1);
+}
 
 template<typename type>
-int64_t AVLSearchTree<type>::getBalance(Node<type>* node) {
-    return (node == nullptr) ? 0 : getHeight(node->right) - getHeight(node->left);
+int64_t AVLSearchTree<type>::countOf(NodeIndex node) const {
+    return (node == no_node) ? 0 : (*pool)[node].count;
 }
 
+
 template<typename type>
-void AVLSearchTree<type>::swapNodes(Node<type>* node1, Node<type>* node2) {
-   std::swap(node1->height, node2->height);
-   std::swap(node1->value, node2->value);
+int64_t AVLSearchTree<type>::getBalance(NodeIndex node) {
+    NodePool<Node<type>>& nodes = *pool;
+
+    return (node == no_node) ? 0 : getHeight(nodes[node].right) - getHeight(nodes[node].left);
 }
 
 template<typename type>
-void AVLSearchTree<type>::rightRotate(Node<type>* node) {
-    Node<type>* temp = node->right;
-    swapNodes(node, node->left);
+NodeIndex AVLSearchTree<type>::rightRotate(NodeIndex node) {
+    NodePool<Node<type>>& nodes = *pool;
+    NodeIndex left = nodes[node].left;
 
-    node->right = node->left;
-    node->left = node->right->left;
-    node->right->left = node->right->right;
-    node->right->right = temp;
-    updateHeight(node->right);
+    nodes[node].left = nodes[left].right;
+    nodes[left].right = node;
     updateHeight(node);
+    updateHeight(left);
+    return left;
 }
 
 template<typename type>
-void AVLSearchTree<type>::leftRotate(Node<type>* node) {
-    swapNodes(node, node->right);
-    Node<type>* temp = node->left;
+NodeIndex AVLSearchTree<type>::leftRotate(NodeIndex node) {
+    NodePool<Node<type>>& nodes = *pool;
+    NodeIndex right = nodes[node].right;
 
-    node->left = node->right;
-    node->right = node->left->right;
-    node->left->right = node->left->left;
-    node->left->left = temp;
-    updateHeight(node->left);
+    nodes[node].right = nodes[right].left;
+    nodes[right].left = node;
     updateHeight(node);
+    updateHeight(right);
+    return right;
 }
 
 template<typename type>
-void AVLSearchTree<type>::balance(Node<type>* node) {
+NodeIndex AVLSearchTree<type>::balance(NodeIndex node) {
+    NodePool<Node<type>>& nodes = *pool;
     int64_t balance = getBalance(node);
 
     if (balance == -2) {
-        if (getBalance(node->left) == 1) {
-            leftRotate(node->left);
+        if (getBalance(nodes[node].left) == 1) {
+            nodes[node].left = leftRotate(nodes[node].left);
         }
-        rightRotate(node);
+        return rightRotate(node);
     } else if (balance == 2) {
-        if (getBalance(node->right) == -1) {
-            rightRotate(node->right);
+        if (getBalance(nodes[node].right) == -1) {
+            nodes[node].right = rightRotate(nodes[node].right);
         }
-        leftRotate(node);
+        return leftRotate(node);
     }
+    return node;
 }
 
 template<typename type>
-void AVLSearchTree<type>::print_NLR(Node<type> *node) const {
-    if (node == nullptr) {
+void AVLSearchTree<type>::print_NLR(NodeIndex node) const {
+    NodePool<Node<type>>& nodes = *pool;
+
+    if (node == no_node) {
         return;
     }
-    std::cout << node->value << " ";
-    print_NLR(node->left);
-    print_NLR(node->right);
+    std::cout << nodes[node].value << " ";
+    print_NLR(nodes[node].left);
+    print_NLR(nodes[node].right);
 }
 
 template<typename type>
-void AVLSearchTree<type>::print_LNR(Node<type> *node) const {
-    if (node == nullptr) {
+void AVLSearchTree<type>::print_LNR(NodeIndex node) const {
+    NodePool<Node<type>>& nodes = *pool;
+
+    if (node == no_node) {
         return;
     }
-    print_LNR(node->left);
-    std::cout << node->value << " ";
-    print_LNR(node->right);
+    print_LNR(nodes[node].left);
+    std::cout << nodes[node].value << " ";
+    print_LNR(nodes[node].right);
 }
 
 template<typename type>
-void AVLSearchTree<type>::print_RNL(Node<type> *node) const {
-    if (node == nullptr) {
+void AVLSearchTree<type>::print_RNL(NodeIndex node) const {
+    NodePool<Node<type>>& nodes = *pool;
+
+    if (node == no_node) {
         return;
     }
-    print_RNL(node->right);
-    std::cout << node->value << " ";
-    print_RNL(node->left);
+    print_RNL(nodes[node].right);
+    std::cout << nodes[node].value << " ";
+    print_RNL(nodes[node].left);
 }
 
 template<typename type>
@@ -432,7 +501,7 @@ void AVLSearchTree<type>::traversalRNL() const {
 
 template<typename type>
 bool AVLSearchTree<type>::isClear() const {
-    if (root == nullptr) {
+    if (root == no_node) {
         return true;
     }
     return false;
@@ -440,24 +509,57 @@ bool AVLSearchTree<type>::isClear() const {
 
 template<typename type>
 void AVLSearchTree<type>::clear() {
-    while (root != nullptr) {
-        remove(root->value);
+    destroy();
+}
+
+template<typename type>
+void AVLSearchTree<type>::destroy() {
+    if ((pool.use_count() > 1) || !std::is_trivially_destructible<type>::value) {  // other trees keep their nodes
+        freeNodes(root);
     }
+    if (pool.use_count() == 1) {
+        pool->release();
+    }
+    root = no_node;
+    size = 0;
 }
 
 template<typename type>
-void AVLSearchTree<type>::print_tree(const Node<type>* node,
+void AVLSearchTree<type>::freeNodes(NodeIndex node) {
+    NodePool<Node<type>>& nodes = *pool;
+    NodeIndex ptr = node;
+
+    while (ptr != no_node) {  // rotate left children up, so every node is freed without a stack
+        if (nodes[ptr].left != no_node) {
+            NodeIndex left = nodes[ptr].left;
+
+            nodes[ptr].left = nodes[left].right;
+            nodes[left].right = ptr;
+            ptr = left;
+        } else {
+            NodeIndex right = nodes[ptr].right;
+
+            nodes.deallocate(ptr);
+            ptr = right;
+        }
+    }
+}
+
+template<typename type>
+void AVLSearchTree<type>::print_tree(NodeIndex node,
                                         int tab, std::ostream& stream) const {
-    if (node == nullptr) {
+    NodePool<Node<type>>& nodes = *pool;
+
+    if (node == no_node) {
         return;
     }
     tab += 1;
-    print_tree(node->right, tab, stream);
+    print_tree(nodes[node].right, tab, stream);
     for (int64_t i = tab; i > 0; --i) {
         stream << "    ";
     }
-    stream << node->value << '\v';
-    print_tree(node->left, tab, stream);
+    stream << nodes[node].value << '\v';
+    print_tree(nodes[node].left, tab, stream);
 }
 
 template<typename type>
@@ -477,3 +579,456 @@ template<typename type>
 int64_t AVLSearchTree<type>::getSize() const {
     return size;
 }
+
+template<typename type>
+type AVLSearchTree<type>::select(const int64_t& index) const {
+    NodePool<Node<type>>& nodes = *pool;
+    NodeIndex ptr = root;
+    int64_t position = index;
+
+    if ((index < 0) || (index >= size)) {
+        std::cout << "\nProblems with select method!\n";
+        return type();
+    }
+    while (true) {
+        int64_t left = countOf(nodes[ptr].left);
+
+        if (position < left) {
+            ptr = nodes[ptr].left;
+        } else if (position == left) {
+            return nodes[ptr].value;
+        } else {
+            position -= left + 1;
+            ptr = nodes[ptr].right;
+        }
+    }
+}
+
+template<typename type>
+int64_t AVLSearchTree<type>::rank(const type& value) const {
+    NodePool<Node<type>>& nodes = *pool;
+    NodeIndex ptr = root;
+    int64_t result = 0;
+
+    while (ptr != no_node) {
+        if (nodes[ptr].value < value) {
+            result += countOf(nodes[ptr].left) + 1;
+            ptr = nodes[ptr].right;
+        } else {
+            ptr = nodes[ptr].left;
+        }
+    }
+    return result;
+}
+
+template<typename type>
+int64_t AVLSearchTree<type>::rankUpper(const type& value) const {
+    NodePool<Node<type>>& nodes = *pool;
+    NodeIndex ptr = root;
+    int64_t result = 0;
+
+    while (ptr != no_node) {
+        if (value < nodes[ptr].value) {
+            ptr = nodes[ptr].left;
+        } else {
+            result += countOf(nodes[ptr].left) + 1;
+            ptr = nodes[ptr].right;
+        }
+    }
+    return result;
+}
+
+template<typename type>
+int64_t AVLSearchTree<type>::countInRange(const type& low, const type& high) const {
+    if (high < low) {
+        return 0;
+    }
+    return rankUpper(high) - rank(low);
+}
+
+template<typename type>
+NodeIndex AVLSearchTree<type>::buildBalanced(const type* values, const int64_t& count) {
+    NodePool<Node<type>>& nodes = *pool;
+
+    if (count == 0) {
+        return no_node;
+    }
+
+    int64_t middle = count / 2;
+    NodeIndex node = pool->allocate(values[middle]);
+    NodeIndex left = buildBalanced(values, middle);
+    NodeIndex right = buildBalanced(values + middle + 1, count - middle - 1);
+
+    nodes[node].left = left;  // the children may have moved the nodes, so node is written last
+    nodes[node].right = right;
+    updateHeight(node);
+    return node;
+}
+
+template<typename type>
+void AVLSearchTree<type>::collect(std::vector<type>& values) const {
+    NodePool<Node<type>>& nodes = *pool;
+    std::vector<NodeIndex> stack;
+    NodeIndex ptr = root;
+
+    while ((ptr != no_node) || !stack.empty()) {
+        while (ptr != no_node) {
+            stack.push_back(ptr);
+            ptr = nodes[ptr].left;
+        }
+        ptr = stack.back();
+        stack.pop_back();
+        values.push_back(nodes[ptr].value);
+        ptr = nodes[ptr].right;
+    }
+}
+
+template<typename type>
+template<typename iterator>
+void AVLSearchTree<type>::buildFromSorted(iterator first, iterator last) {
+    try {
+        std::vector<type> values(first, last);
+
+        destroy();
+        root = buildBalanced(values.data(), static_cast<int64_t>(values.size()));
+        size = static_cast<int64_t>(values.size());
+    } catch (...) {
+        destroy();
+        std::cout << "\nBuild method threw except\n";
+    }
+}
+
+template<typename type>
+void AVLSearchTree<type>::merge(const AVLSearchTree<type>& tree) {
+    try {
+        std::vector<type> first;
+        std::vector<type> second;
+        std::vector<type> values;
+
+        first.reserve(size);
+        second.reserve(tree.size);
+        collect(first);
+        tree.collect(second);
+        values.reserve(first.size() + second.size());
+        std::merge(first.begin(), first.end(), second.begin(), second.end(), std::back_inserter(values));
+        buildFromSorted(values.begin(), values.end());
+    } catch (...) {
+        std::cout << "\nMerge method threw except\n";
+    }
+}
+
+template<typename type>
+NodeIndex AVLSearchTree<type>::joinNodes(NodeIndex left, NodeIndex middle, NodeIndex right) {
+    NodePool<Node<type>>& nodes = *pool;
+
+    if (getHeight(left) > getHeight(right) + 1) {
+        return joinRight(left, middle, right);
+    }
+    if (getHeight(right) > getHeight(left) + 1) {
+        return joinLeft(left, middle, right);
+    }
+    nodes[middle].left = left;
+    nodes[middle].right = right;
+    updateHeight(middle);
+    return middle;
+}
+
+template<typename type>
+NodeIndex AVLSearchTree<type>::joinRight(NodeIndex left, NodeIndex middle, NodeIndex right) {
+    NodePool<Node<type>>& nodes = *pool;
+
+    if (getHeight(left) <= getHeight(right) + 1) {
+        nodes[middle].left = left;
+        nodes[middle].right = right;
+        updateHeight(middle);
+        return middle;
+    }
+    nodes[left].right = joinRight(nodes[left].right, middle, right);  // go down the right spine to the height of right
+    updateHeight(left);
+    return balance(left);
+}
+
+template<typename type>
+NodeIndex AVLSearchTree<type>::joinLeft(NodeIndex left, NodeIndex middle, NodeIndex right) {
+    NodePool<Node<type>>& nodes = *pool;
+
+    if (getHeight(right) <= getHeight(left) + 1) {
+        nodes[middle].left = left;
+        nodes[middle].right = right;
+        updateHeight(middle);
+        return middle;
+    }
+    nodes[right].left = joinLeft(left, middle, nodes[right].left);
+    updateHeight(right);
+    return balance(right);
+}
+
+template<typename type>
+NodeIndex AVLSearchTree<type>::detachMax(NodeIndex node, NodeIndex& max) {
+    NodePool<Node<type>>& nodes = *pool;
+
+    if (nodes[node].right == no_node) {
+        NodeIndex left = nodes[node].left;
+
+        max = node;
+        nodes[node].left = no_node;
+        updateHeight(node);
+        return left;
+    }
+    nodes[node].right = detachMax(nodes[node].right, max);
+    updateHeight(node);
+    return balance(node);
+}
+
+template<typename type>
+NodeIndex AVLSearchTree<type>::joinTwo(NodeIndex left, NodeIndex right) {
+    NodeIndex middle = no_node;
+
+    if (left == no_node) {
+        return right;
+    }
+    if (right == no_node) {
+        return left;
+    }
+    left = detachMax(left, middle);
+    return joinNodes(left, middle, right);
+}
+
+template<typename type>
+void AVLSearchTree<type>::splitNodes(NodeIndex node, const type& key, bool inclusive,
+                                     NodeIndex& left, NodeIndex& right) {
+    NodePool<Node<type>>& nodes = *pool;
+
+    if (node == no_node) {
+        left = no_node;
+        right = no_node;
+        return;
+    }
+
+    NodeIndex node_left = nodes[node].left;
+    NodeIndex node_right = nodes[node].right;
+
+    if (inclusive ? !(key < nodes[node].value) : (nodes[node].value < key)) {
+        NodeIndex rest = no_node;
+
+        splitNodes(node_right, key, inclusive, rest, right);
+        left = joinNodes(node_left, node, rest);
+    } else {
+        NodeIndex rest = no_node;
+
+        splitNodes(node_left, key, inclusive, left, rest);
+        right = joinNodes(rest, node, node_right);
+    }
+}
+
+template<typename type>
+NodeIndex AVLSearchTree<type>::setOperation(NodeIndex first, NodeIndex second, Operation operation,
+                                            int64_t threads, std::vector<NodeIndex>& garbage) {
+    NodePool<Node<type>>& nodes = *pool;
+
+    if ((first == no_node) || (second == no_node)) {
+        if (operation == Operation::unite) {
+            return (first == no_node) ? second : first;
+        }
+        garbage.push_back(second);
+        if (operation == Operation::subtract) {
+            return first;
+        }
+        garbage.push_back(first);
+        return no_node;
+    }
+
+    type key = nodes[second].value;
+    NodeIndex first_less = no_node;
+    NodeIndex first_equal = no_node;
+    NodeIndex first_greater = no_node;
+    NodeIndex second_less = no_node;
+    NodeIndex second_equal = no_node;
+    NodeIndex second_greater = no_node;
+    NodeIndex middle = no_node;
+
+    splitNodes(first, key, false, first_less, first_greater);
+    splitNodes(first_greater, key, true, first_equal, first_greater);
+    splitNodes(second, key, false, second_less, second_greater);  // equal keys may sit on both sides of the root
+    splitNodes(second_greater, key, true, second_equal, second_greater);
+
+    int64_t first_count = countOf(first_equal);
+    int64_t second_count = countOf(second_equal);
+
+    if (operation == Operation::subtract) {  // keep first_count - second_count copies of key
+        for (int64_t i = 0; (i < second_count) && (first_equal != no_node); ++i) {
+            NodeIndex removed = no_node;
+
+            first_equal = detachMax(first_equal, removed);
+            garbage.push_back(removed);
+        }
+        garbage.push_back(second_equal);
+        middle = first_equal;
+    } else if ((operation == Operation::unite) == (first_count >= second_count)) {  // max or min of the counts
+        garbage.push_back(second_equal);
+        middle = first_equal;
+    } else {
+        garbage.push_back(first_equal);
+        middle = second_equal;
+    }
+
+    NodeIndex left = no_node;
+    NodeIndex right = no_node;
+
+    if ((threads > 1) && (countOf(first_less) + countOf(second_less) > parallel_grain) &&
+        (countOf(first_greater) + countOf(second_greater) > parallel_grain)) {
+        // the policy lets the task run inline when no thread can be started; the pool is
+        // only read and relinked in parallel, the task keeps its own garbage
+        std::vector<NodeIndex> task_garbage;
+        std::future<NodeIndex> task = std::async(std::launch::async | std::launch::deferred,
+                                                 [&]() {
+                                                     return setOperation(first_less, second_less,
+                                                                         operation, threads / 2, task_garbage);
+                                                 });
+
+        right = setOperation(first_greater, second_greater, operation, threads - threads / 2, garbage);
+        left = task.get();
+        garbage.insert(garbage.end(), task_garbage.begin(), task_garbage.end());
+    } else {
+        left = setOperation(first_less, second_less, operation, 1, garbage);
+        right = setOperation(first_greater, second_greater, operation, 1, garbage);
+    }
+    if ((middle != no_node) && (nodes[middle].count == 1)) {
+        return joinNodes(left, middle, right);
+    }
+    return joinTwo(joinTwo(left, middle), right);
+}
+
+template<typename type>
+void AVLSearchTree<type>::setOperation(AVLSearchTree<type>& tree, Operation operation,
+                                       const int64_t& threads) {
+    if (&tree == this) {
+        if (operation == Operation::subtract) {
+            destroy();
+        }
+        return;
+    }
+    try {
+        std::vector<NodeIndex> garbage;  // dropped subtrees, freed after the threads are done
+
+        sharePool(tree);
+        tree.pool = std::make_shared<NodePool<Node<type>>>();
+        root = setOperation(root, tree.root, operation, threads, garbage);
+        size = countOf(root);
+        tree.root = no_node;
+        tree.size = 0;
+        for (NodeIndex node : garbage) {
+            freeNodes(node);
+        }
+    } catch (...) {
+        std::cout << "\nSet operation threw except\n";
+    }
+}
+
+template<typename type>
+void AVLSearchTree<type>::sharePool(AVLSearchTree<type>& tree) {
+    if (pool == tree.pool) {
+        return;
+    }
+    if (size > tree.size) {
+        tree.sharePool(*this);
+        return;
+    }
+
+    NodeIndex copy = tree.copyNodes(*pool, root);  // the source stays intact if a copy throws
+    int64_t count = size;
+
+    destroy();
+    pool = tree.pool;
+    root = copy;
+    size = count;
+}
+
+template<typename type>
+NodeIndex AVLSearchTree<type>::copyNodes(const NodePool<Node<type>>& from, NodeIndex node) {
+    if (node == no_node) {
+        return no_node;
+    }
+
+    NodeIndex copy = pool->allocate(from[node].value);
+    NodeIndex left = no_node;
+
+    try {
+        left = copyNodes(from, from[node].left);
+
+        NodeIndex right = copyNodes(from, from[node].right);
+        Node<type>& target = (*pool)[copy];  // taken after the copies, which may move the nodes
+
+        target.left = left;
+        target.right = right;
+        target.height = from[node].height;
+        target.count = from[node].count;
+    } catch (...) {
+        freeNodes(left);
+        pool->deallocate(copy);
+        throw;
+    }
+    return copy;
+}
+
+template<typename type>
+void AVLSearchTree<type>::join(AVLSearchTree<type>& tree) {
+    try {
+        if ((&tree == this) || tree.isClear()) {
+            return;
+        }
+        if (!isClear() && (tree.select(0) < select(size - 1))) {
+            throw std::exception();
+        }
+        sharePool(tree);
+        tree.pool = std::make_shared<NodePool<Node<type>>>();
+        root = joinTwo(root, tree.root);
+        size += tree.size;
+        tree.root = no_node;
+        tree.size = 0;
+    } catch (...) {
+        std::cout << "\nJoin method threw except\n";
+    }
+}
+
+template<typename type>
+void AVLSearchTree<type>::split(const type& key, AVLSearchTree<type>& tree) {
+    if (&tree == this) {
+        return;
+    }
+
+    NodeIndex left = no_node;
+    NodeIndex right = no_node;
+
+    tree.destroy();
+    tree.pool = pool;
+    splitNodes(root, key, false, left, right);
+    root = left;
+    size = countOf(left);
+    tree.root = right;
+    tree.size = countOf(right);
+}
+
+template<typename type>
+void AVLSearchTree<type>::unite(AVLSearchTree<type>& tree, const int64_t& threads) {
+    setOperation(tree, Operation::unite, threads);
+}
+
+template<typename type>
+void AVLSearchTree<type>::intersect(AVLSearchTree<type>& tree, const int64_t& threads) {
+    setOperation(tree, Operation::intersect, threads);
+}
+
+template<typename type>
+void AVLSearchTree<type>::subtract(AVLSearchTree<type>& tree, const int64_t& threads) {
+    setOperation(tree, Operation::subtract, threads);
+}
+
+template<typename type>
+FrozenTree<type> AVLSearchTree<type>::freeze() const {
+    std::vector<type> values;
+
+    values.reserve(size);
+    collect(values);
+    return FrozenTree<type>(values.begin(), values.end());
+}
@@ -2,7 +2,13 @@
 #pragma once
 
 #include "../../libs.hpp"
+#include "frozen_tree.hpp"
+#include "node_pool.hpp"
 
+// Node of BinarySearchTree. Nodes live in the NodePool of their tree and link
+// to each other with 32-bit pool indices, so with the parent link and the
+// subtree count used by the iterators and by select/rank a node with an int
+// value takes 20 bytes instead of 40 with pointers.
 template<typename type>
 class TreeNode {
  public:
@@ -13,8 +19,47 @@ class TreeNode {
     ~TreeNode() = default;  // destructor
 
     type value = 0;  // value
-    TreeNode<type>* left = nullptr;  // pointer to the left node
-    TreeNode<type>* right = nullptr;  // pointer to the right node
+    NodeIndex left = no_node;  // index of the left node
+    NodeIndex right = no_node;  // index of the right node
+    NodeIndex parent = no_node;  // index of the parent node
+    uint32_t count = 1;  // number of nodes in the subtree
+};
+
+template<typename type>
+class BinarySearchTree;
+
+template<typename type>
+class TreeIterator {  // bidirectional in-order iterator, invalidated when its node is removed
+ public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const type*;
+    using reference = const type&;
+
+    TreeIterator() = default;  // constructor without parameters
+
+    TreeIterator(const BinarySearchTree<type>* tree, const NodeIndex& node);  // constructor with parameters
+
+    const type& operator*() const;  // value of the node
+
+    const type* operator->() const;  // pointer to the value of the node
+
+    TreeIterator<type>& operator++();  // go to the next node in order
+
+    TreeIterator<type> operator++(int);  // go to the next node in order
+
+    TreeIterator<type>& operator--();  // go to the previous node in order
+
+    TreeIterator<type> operator--(int);  // go to the previous node in order
+
+    bool operator==(const TreeIterator<type>& iterator) const;  // for comparison
+
+    bool operator!=(const TreeIterator<type>& iterator) const;  // for comparison
+
+ private:
+    const BinarySearchTree<type>* tree = nullptr;  // tree of the node
+    NodeIndex node = no_node;  // current node, no_node for end
 };
 
 template<typename type>
@@ -36,6 +81,11 @@ class BinarySearchTree {
 
     void remove(const type& value);  // delete element
 
+    template<typename iterator>
+    void buildFromSorted(iterator first, iterator last);  // replace content with a balanced tree of sorted range, O(n)
+
+    void merge(const BinarySearchTree<type>& tree);  // add all elements of tree, O(n + m)
+
     void traversalNLR() const;  // tree traversal NRL
 
     void traversalLNR() const;  // tree traversal LNR
@@ -48,20 +98,55 @@ class BinarySearchTree {
 
     int64_t getSize() const;  // returns the current size of tree
 
+    TreeIterator<type> begin() const;  // iterator to the min element
+
+    TreeIterator<type> end() const;  // iterator past the max element
+
+    TreeIterator<type> lowerBound(const type& value) const;  // first element not less than value
+
+    TreeIterator<type> upperBound(const type& value) const;  // first element greater than value
+
+    template<typename function>
+    void rangeForEach(const type& low, const type& high, function fn) const;  // call fn for elements in [low, high]
+
+    type select(const int64_t& index) const;  // element with the given index in order, from 0
+
+    int64_t rank(const type& value) const;  // number of elements less than value
+
+    int64_t countInRange(const type& low, const type& high) const;  // number of elements in [low, high]
+
+    FrozenTree<type> freeze() const;  // read-only copy in Eytzinger layout for fast lookups
+
     template<typename new_type>
     friend std::ostream& operator<<(std::ostream& stream,
                                     const BinarySearchTree<new_type>& tree);  // for print
 
+    friend class TreeIterator<type>;
+
  private:
-    void print_NLR(TreeNode<type>* node) const;  // recursive method for traversal NRL
+    void print_NLR(const NodeIndex& node) const;  // recursive method for traversal NRL
+
+    void print_LNR(const NodeIndex& node) const;  // recursive method for traversal LNR
 
-    void print_LNR(TreeNode<type>* node) const;  // recursive method for traversal LNR
+    void print_RNL(const NodeIndex& node) const;  // recursive method for traversal RNL
 
-    void print_RNL(TreeNode<type>* node) const;  // recursive method for traversal RNL
+    void print_tree(const NodeIndex& node, int tab, std::ostream& stream) const;  // method for print tree
 
-    void print_tree(const TreeNode<type>* node, int tab, std::ostream& stream) const;  // method for print tree
+    void destroy();  // free all nodes in O(n) without recursion
 
-    TreeNode<type>* root = nullptr;  // pointer to the root of the tree
+    NodeIndex leftmost(NodeIndex node) const;  // min node of the subtree
+
+    NodeIndex rightmost(NodeIndex node) const;  // max node of the subtree
+
+    int64_t countOf(const NodeIndex& node) const;  // number of nodes in the subtree
+
+    int64_t rankUpper(const type& value) const;  // number of elements not greater than value
+
+    NodeIndex buildBalanced(const type* values, const int64_t& count,
+                            const NodeIndex& parent);  // balanced subtree of sorted values
+
+    NodePool<TreeNode<type>> pool;  // storage of the nodes
+    NodeIndex root = no_node;  // index of the root of the tree
     int64_t min_size = std::numeric_limits<int64_t>::min();  // min value
     int64_t max_size = std::numeric_limits<int64_t>::max();  // max value
     int64_t size = 0;  // current capacity of the tree
@@ -74,7 +159,7 @@ template<typename type>
 BinarySearchTree<type>::BinarySearchTree(const type& value) {
     try {
         if (min_size <= size <= max_size) {
-            root = new TreeNode<type>(value);
+            root = pool.allocate(value);
 
             ++size;
         } else {
@@ -87,22 +172,22 @@ BinarySearchTree<type>::BinarySearchTree(const type& value) {
 
 template<typename type>
 BinarySearchTree<type>::~BinarySearchTree() {
-    while (root != nullptr) {
-        remove(root->value);
-    }
+    destroy();
 }
 
 template<typename type>
 bool BinarySearchTree<type>::find(const type& value) const {
-    TreeNode<type>* ptr = root;
+    NodeIndex ptr = root;
 
-    while (ptr != nullptr) {
-        if (ptr->value == value) {
+    while (ptr != no_node) {
+        const TreeNode<type>& node = pool[ptr];
+
+        if (node.value == value) {
             return true;
-        } else if (ptr->value > value) {
-            ptr = ptr->left;
+        } else if (node.value > value) {
+            ptr = node.left;
         } else {
-            ptr = ptr->right;
+            ptr = node.right;
         }
     }
     return false;
@@ -110,42 +195,28 @@ bool BinarySearchTree<type>::find(const type& value) const {
 
 template<typename type>
 type BinarySearchTree<type>::findMin() const {
-    TreeNode<type>* ptr = root;
-    TreeNode<type>* parent_ptr = root;
-
-    if (ptr == nullptr) {
+    if (root == no_node) {
         return NULL;
     }
-    while (ptr != nullptr) {
-        parent_ptr = ptr;
-        ptr = ptr->left;
-    }
-    return parent_ptr->value;
+    return pool[leftmost(root)].value;
 }
 
 template<typename type>
 type BinarySearchTree<type>::findMax() const {
-    TreeNode<type>* ptr = root;
-    TreeNode<type>* parent_ptr = root;
-
-    if (ptr == nullptr) {
+    if (root == no_node) {
         return NULL;
     }
-    while (ptr != nullptr) {
-        parent_ptr = ptr;
-        ptr = ptr->right;
-    }
-    return parent_ptr->value;
+    return pool[rightmost(root)].value;
 }
 
 template<typename type>
 void BinarySearchTree<type>::add(const type& value) {
-    TreeNode<type>* ptr = root;
+    NodeIndex ptr = root;
 
     try {
-        if (root == nullptr) {
+        if (root == no_node) {
             if (min_size <= size <= max_size) {
-                root = new TreeNode<type>(value);
+                root = pool.allocate(value);
 
                 ++size;
             } else {
@@ -154,25 +225,22 @@ void BinarySearchTree<type>::add(const type& value) {
             return;
         }
         while (true) {
-            if (ptr->value > value) {
-                if (ptr->left == nullptr) {
-                    ptr->left = new TreeNode<type>(value);
-
-                    ++size;
-                    return;
-                } else {
-                    ptr = ptr->left;
-                }
-            } else {
-                if (ptr->right == nullptr) {
-                    ptr->right = new TreeNode<type>(value);
+            bool is_left = pool[ptr].value > value;
+            NodeIndex next = is_left ? pool[ptr].left : pool[ptr].right;
+
+            if (next == no_node) {
+                NodeIndex node = pool.allocate(value);  // may move the nodes, so the link is taken after it
 
-                    ++size;
-                    return;
-                } else {
-                    ptr = ptr->right;
+                (is_left ? pool[ptr].left : pool[ptr].right) = node;
+                pool[node].parent = ptr;
+                for (; ptr != no_node; ptr = pool[ptr].parent) {
+                    ++pool[ptr].count;
                 }
+
+                ++size;
+                return;
             }
+            ptr = next;
         }
     } catch (...)  {
         std::cout << "\nAdd method threw except\n";
@@ -181,90 +249,42 @@ void BinarySearchTree<type>::add(const type& value) {
 
 template<typename type>
 void BinarySearchTree<type>::remove(const type& value) {
-    TreeNode<type>* ptr = root;
-    TreeNode<type>* parent_ptr = root;
-    bool is_left = true;
+    NodeIndex ptr = root;
 
-    if (!find(value)) {
-        return;
+    while ((ptr != no_node) &&
+           (pool[ptr].value != value)) {  // search delete element
+        ptr = (pool[ptr].value > value) ? pool[ptr].left : pool[ptr].right;
     }
 
-    while ((ptr != nullptr) &&
-           (ptr->value != value)) {  // search delete element
-        parent_ptr = ptr;
-
-        if (ptr->value > value) {
-            is_left = true;
-            ptr = ptr->left;
-        } else {
-            is_left = false;
-            ptr = ptr->right;
-        }
-    }
-
-    if (ptr == nullptr) {  // if did not search delete element
+    if (ptr == no_node) {  // if did not search delete element
         return;
     }
 
     try {
-        if ((ptr->left == nullptr) &&
-            (ptr->right == nullptr)) {  // delete if no child
-            if (ptr == root) {
-                delete root;
-                root = nullptr;
-            } else if (is_left) {
-                delete parent_ptr->left;
-                parent_ptr->left = nullptr;
-            } else {
-                delete parent_ptr->right;
-                parent_ptr->right = nullptr;
-            }
-        } else if (ptr->right == nullptr) {  // delete if only left child
-            if (ptr == root) {
-                TreeNode<type>* temp = root;
-
-                root = ptr->left;
-                delete temp;
-            } else if (is_left) {
-                parent_ptr->left = ptr->left;
-                delete ptr;
-            } else {
-                parent_ptr->right = ptr->left;
-                delete ptr;
-            }
-        } else if (ptr->left == nullptr) {  // delete if only right child
-            if (ptr == root) {
-                TreeNode<type>* temp = root;
-
-                root = ptr->right;
-                delete temp;
-            } else if (is_left) {
-                parent_ptr->left = ptr->right;
-                delete ptr;
-            } else {
-                parent_ptr->right = ptr->right;
-                delete ptr;
-            }
-        } else {  // delete if two child
-            TreeNode<type>* successor = ptr;
-            TreeNode<type>* parent_successor = ptr;
-            TreeNode<type>* child_successor = ptr->right;
-
-            while (child_successor != nullptr) {
-                parent_successor = successor;
-                successor = child_successor;
-                child_successor = child_successor->left;
-            }
+        TreeNode<type>& node = pool[ptr];
+        NodeIndex removed = ((node.left != no_node) && (node.right != no_node)) ? leftmost(node.right) : ptr;
 
-            if (successor != ptr->right) {
-                parent_successor->left = successor->right;
-            } else {
-                ptr->right = successor->right;
-            }
+        for (NodeIndex temp = pool[removed].parent; temp != no_node; temp = pool[temp].parent) {
+            --pool[temp].count;
+        }
+
+        NodeIndex child = (pool[removed].left != no_node) ? pool[removed].left : pool[removed].right;
+        NodeIndex parent = pool[removed].parent;
 
-            ptr->value = successor->value;
-            delete successor;
+        if (child != no_node) {
+            pool[child].parent = parent;
+        }
+        if (parent == no_node) {
+            root = child;
+        } else if (pool[parent].left == removed) {
+            pool[parent].left = child;
+        } else {
+            pool[parent].right = child;
+        }
+        if (removed != ptr) {  // two children: the successor gives its value and is freed instead
+            node.value = pool[removed].value;
         }
+        pool.deallocate(removed);
         --size;
     } catch (...) {
         std::cout << "\nRemove method threw except\n";
@@ -272,33 +292,33 @@ void BinarySearchTree<type>::remove(const type& value) {
 }
 
 template<typename type>
-void BinarySearchTree<type>::print_NLR(TreeNode<type> *node) const {
-    if (node == nullptr) {
+void BinarySearchTree<type>::print_NLR(const NodeIndex& node) const {
+    if (node == no_node) {
         return;
     }
-    std::cout << node->value << ' ';
-    print_NLR(node->left);
-    print_NLR(node->right);
+    std::cout << pool[node].value << ' ';
+    print_NLR(pool[node].left);
+    print_NLR(pool[node].right);
 }
 
 template<typename type>
-void BinarySearchTree<type>::print_LNR(TreeNode<type> *node) const {
-    if (node == nullptr) {
+void BinarySearchTree<type>::print_LNR(const NodeIndex& node) const {
+    if (node == no_node) {
         return;
     }
-    print_LNR(node->left);
-    std::cout << node->value << ' ';
-    print_LNR(node->right);
+    print_LNR(pool[node].left);
+    std::cout << pool[node].value << ' ';
+    print_LNR(pool[node].right);
 }
 
 template<typename type>
-void BinarySearchTree<type>::print_RNL(TreeNode<type> *node) const {
-    if (node == nullptr) {
+void BinarySearchTree<type>::print_RNL(const NodeIndex& node) const {
+    if (node == no_node) {
         return;
     }
-    print_RNL(node->right);
-    std::cout << node->value << ' ';
-    print_RNL(node->left);
+    print_RNL(pool[node].right);
+    std::cout << pool[node].value << ' ';
+    print_RNL(pool[node].left);
 }
 
 template<typename type>
@@ -318,7 +338,7 @@ void BinarySearchTree<type>::traversalRNL() const {
 
 template<typename type>
 bool BinarySearchTree<type>::isClear() const {
-    if (root == nullptr) {
+    if (root == no_node) {
         return true;
     }
     return false;
@@ -326,24 +346,47 @@ bool BinarySearchTree<type>::isClear() const {
 
 template<typename type>
 void BinarySearchTree<type>::clear() {
-    while (root != nullptr) {
-        remove(root->value);
+    destroy();
+}
+
+template<typename type>
+void BinarySearchTree<type>::destroy() {
+    if (!std::is_trivially_destructible<type>::value) {
+        NodeIndex ptr = root;
+
+        while (ptr != no_node) {  // rotate left children up, so every node is freed without a stack
+            NodeIndex left = pool[ptr].left;
+
+            if (left != no_node) {
+                pool[ptr].left = pool[left].right;
+                pool[left].right = ptr;
+                ptr = left;
+            } else {
+                NodeIndex right = pool[ptr].right;
+
+                pool.deallocate(ptr);
+                ptr = right;
+            }
+        }
     }
+    pool.release();
+    root = no_node;
+    size = 0;
 }
 
 template<typename type>
-void BinarySearchTree<type>::print_tree(const TreeNode<type>* node,
+void BinarySearchTree<type>::print_tree(const NodeIndex& node,
                                         int tab, std::ostream& stream) const {
-    if (node == nullptr) {
+    if (node == no_node) {
         return;
     }
     tab += 1;
-    print_tree(node->right, tab, stream);
+    print_tree(pool[node].right, tab, stream);
     for (int64_t i = tab; i > 0; --i) {
         stream << "    ";
     }
-    stream << node->value << '\v';
-    print_tree(node->left, tab, stream);
+    stream << pool[node].value << '\v';
+    print_tree(pool[node].left, tab, stream);
 }
 
 template<typename type>
@@ -363,3 +406,263 @@ template<typename type>
 int64_t BinarySearchTree<type>::getSize() const {
     return size;
 }
+
+template<typename type>
+NodeIndex BinarySearchTree<type>::leftmost(NodeIndex node) const {
+    while ((node != no_node) && (pool[node].left != no_node)) {
+        node = pool[node].left;
+    }
+    return node;
+}
+
+template<typename type>
+NodeIndex BinarySearchTree<type>::rightmost(NodeIndex node) const {
+    while ((node != no_node) && (pool[node].right != no_node)) {
+        node = pool[node].right;
+    }
+    return node;
+}
+
+template<typename type>
+TreeIterator<type> BinarySearchTree<type>::begin() const {
+    return TreeIterator<type>(this, leftmost(root));
+}
+
+template<typename type>
+TreeIterator<type> BinarySearchTree<type>::end() const {
+    return TreeIterator<type>(this, no_node);
+}
+
+template<typename type>
+TreeIterator<type> BinarySearchTree<type>::lowerBound(const type& value) const {
+    NodeIndex ptr = root;
+    NodeIndex result = no_node;
+
+    while (ptr != no_node) {
+        if (pool[ptr].value < value) {
+            ptr = pool[ptr].right;
+        } else {
+            result = ptr;
+            ptr = pool[ptr].left;
+        }
+    }
+    return TreeIterator<type>(this, result);
+}
+
+template<typename type>
+TreeIterator<type> BinarySearchTree<type>::upperBound(const type& value) const {
+    NodeIndex ptr = root;
+    NodeIndex result = no_node;
+
+    while (ptr != no_node) {
+        if (value < pool[ptr].value) {
+            result = ptr;
+            ptr = pool[ptr].left;
+        } else {
+            ptr = pool[ptr].right;
+        }
+    }
+    return TreeIterator<type>(this, result);
+}
+
+template<typename type>
+template<typename function>
+void BinarySearchTree<type>::rangeForEach(const type& low, const type& high, function fn) const {
+    for (TreeIterator<type> it = lowerBound(low); (it != end()) && !(high < *it); ++it) {
+        fn(*it);
+    }
+}
+
+template<typename type>
+int64_t BinarySearchTree<type>::countOf(const NodeIndex& node) const {
+    return (node == no_node) ? 0 : pool[node].count;
+}
+
+template<typename type>
+type BinarySearchTree<type>::select(const int64_t& index) const {
+    NodeIndex ptr = root;
+    int64_t position = index;
+
+    if ((index < 0) || (index >= size)) {
+        std::cout << "\nProblems with select method!\n";
+        return type();
+    }
+    while (true) {
+        int64_t left = countOf(pool[ptr].left);
+
+        if (position < left) {
+            ptr = pool[ptr].left;
+        } else if (position == left) {
+            return pool[ptr].value;
+        } else {
+            position -= left + 1;
+            ptr = pool[ptr].right;
+        }
+    }
+}
+
+template<typename type>
+int64_t BinarySearchTree<type>::rank(const type& value) const {
+    NodeIndex ptr = root;
+    int64_t result = 0;
+
+    while (ptr != no_node) {
+        if (pool[ptr].value < value) {
+            result += countOf(pool[ptr].left) + 1;
+            ptr = pool[ptr].right;
+        } else {
+            ptr = pool[ptr].left;
+        }
+    }
+    return result;
+}
+
+template<typename type>
+int64_t BinarySearchTree<type>::rankUpper(const type& value) const {
+    NodeIndex ptr = root;
+    int64_t result = 0;
+
+    while (ptr != no_node) {
+        if (value < pool[ptr].value) {
+            ptr = pool[ptr].left;
+        } else {
+            result += countOf(pool[ptr].left) + 1;
+            ptr = pool[ptr].right;
+        }
+    }
+    return result;
+}
+
+template<typename type>
+int64_t BinarySearchTree<type>::countInRange(const type& low, const type& high) const {
+    if (high < low) {
+        return 0;
+    }
+    return rankUpper(high) - rank(low);
+}
+
+template<typename type>
+TreeIterator<type>::TreeIterator(const BinarySearchTree<type>* tree,
+                                 const NodeIndex& node) : tree(tree), node(node) {}
+
+template<typename type>
+const type& TreeIterator<type>::operator*() const {
+    return tree->pool[node].value;
+}
+
+template<typename type>
+const type* TreeIterator<type>::operator->() const {
+    return &tree->pool[node].value;
+}
+
+template<typename type>
+TreeIterator<type>& TreeIterator<type>::operator++() {
+    const NodePool<TreeNode<type>>& pool = tree->pool;
+
+    if (pool[node].right != no_node) {
+        node = tree->leftmost(pool[node].right);
+        return *this;
+    }
+    while ((pool[node].parent != no_node) && (node == pool[pool[node].parent].right)) {
+        node = pool[node].parent;
+    }
+    node = pool[node].parent;
+    return *this;
+}
+
+template<typename type>
+TreeIterator<type> TreeIterator<type>::operator++(int) {
+    TreeIterator<type> temp = *this;
+
+    ++(*this);
+    return temp;
+}
+
+template<typename type>
+TreeIterator<type>& TreeIterator<type>::operator--() {
+    const NodePool<TreeNode<type>>& pool = tree->pool;
+
+    if (node == no_node) {  // step back from end
+        node = tree->rightmost(tree->root);
+        return *this;
+    }
+    if (pool[node].left != no_node) {
+        node = tree->rightmost(pool[node].left);
+        return *this;
+    }
+    while ((pool[node].parent != no_node) && (node == pool[pool[node].parent].left)) {
+        node = pool[node].parent;
+    }
+    node = pool[node].parent;
+    return *this;
+}
+
+template<typename type>
+TreeIterator<type> TreeIterator<type>::operator--(int) {
+    TreeIterator<type> temp = *this;
+
+    --(*this);
+    return temp;
+}
+
+template<typename type>
+bool TreeIterator<type>::operator==(const TreeIterator<type>& iterator) const {
+    return node == iterator.node;
+}
+
+template<typename type>
+bool TreeIterator<type>::operator!=(const TreeIterator<type>& iterator) const {
+    return node != iterator.node;
+}
+
+template<typename type>
+NodeIndex BinarySearchTree<type>::buildBalanced(const type* values, const int64_t& count,
+                                                const NodeIndex& parent) {
+    if (count == 0) {
+        return no_node;
+    }
+
+    int64_t middle = count / 2;
+    NodeIndex node = pool.allocate(values[middle]);
+    NodeIndex left = buildBalanced(values, middle, node);
+    NodeIndex right = buildBalanced(values + middle + 1, count - middle - 1, node);
+
+    pool[node].parent = parent;  // the children may have moved the nodes, so node is written last
+    pool[node].count = static_cast<uint32_t>(count);
+    pool[node].left = left;
+    pool[node].right = right;
+    return node;
+}
+
+template<typename type>
+template<typename iterator>
+void BinarySearchTree<type>::buildFromSorted(iterator first, iterator last) {
+    try {
+        std::vector<type> values(first, last);
+
+        destroy();
+        root = buildBalanced(values.data(), static_cast<int64_t>(values.size()), no_node);
+        size = static_cast<int64_t>(values.size());
+    } catch (...) {
+        destroy();
+        std::cout << "\nBuild method threw except\n";
+    }
+}
+
+template<typename type>
+void BinarySearchTree<type>::merge(const BinarySearchTree<type>& tree) {
+    try {
+        std::vector<type> values;
+
+        values.reserve(size + tree.size);
+        std::merge(begin(), end(), tree.begin(), tree.end(), std::back_inserter(values));
+        buildFromSorted(values.begin(), values.end());
+    } catch (...) {
+        std::cout << "\nMerge method threw except\n";
+    }
+}
+
+template<typename type>
+FrozenTree<type> BinarySearchTree<type>::freeze() const {
+    return FrozenTree<type>(begin(), end());
+}
@@ -0,0 +1,504 @@
+// Copyright 2023 binoll
+#pragma once
+
+#include "../../libs.hpp"
+
+// B+-tree: an ordered container with up to capacity keys per node, so a lookup
+// visits about log_capacity(n) nodes instead of the log2(n) of a binary tree,
+// and the keys of one node sit in a few adjacent cache lines. The default
+// capacity fills 256 bytes (four cache lines) with keys. All elements live in
+// the leaves, which are linked in order for range scans; inner nodes only hold
+// separators. Inside a node arithmetic keys are found with a branchless scan
+// and other keys with binary search. Duplicates are allowed, as in
+// BinarySearchTree.
+template<typename type, int64_t capacity = (256 / sizeof(type) < 8) ? 8 : 256 / sizeof(type)>
+class BTree {
+ public:
+    BTree() = default;  // constructor without parameters
+
+    explicit BTree(const type& value);  // constructor with parameters
+
+    BTree(const BTree<type, capacity>& tree) = delete;
+
+    BTree<type, capacity>& operator=(const BTree<type, capacity>& tree) = delete;
+
+    ~BTree();  // destructor
+
+    bool find(const type& value) const;  // searching for an element
+
+    type findMin() const;  // return min element
+
+    type findMax() const;  // return max element
+
+    void add(const type& value);  // add element
+
+    void remove(const type& value);  // delete element
+
+    template<typename function>
+    void rangeForEach(const type& low, const type& high, function fn) const;  // call fn for elements in [low, high]
+
+    bool isClear() const;  // checking for emptiness
+
+    void clear();  // cleaning the tree
+
+    int64_t getSize() const;  // returns the current size of tree
+
+    int64_t getHeight() const;  // returns the number of levels
+
+    template<typename new_type, int64_t new_capacity>
+    friend std::ostream& operator<<(std::ostream& stream,
+                                    const BTree<new_type, new_capacity>& tree);  // print
+
+ private:
+    static_assert(capacity >= 4, "BTree needs at least 4 keys per node");
+
+    struct BNode {
+        int64_t count = 0;  // number of keys
+        bool leaf = true;  // leaf or inner node
+        type keys[capacity];  // elements in a leaf, separators in an inner node
+    };
+
+    struct Leaf : BNode {
+        Leaf* next = nullptr;  // next leaf in order
+    };
+
+    struct Inner : BNode {
+        Inner() {
+            this->leaf = false;
+        }
+
+        BNode* children[capacity + 1];  // subtrees, child i holds keys between keys[i - 1] and keys[i]
+    };
+
+    static constexpr int64_t min_keys = capacity / 2;  // min keys of a node other than the root
+
+    static int64_t lowerIndex(const type* keys, const int64_t& count,
+                              const type& value);  // number of keys less than value
+
+    static int64_t lowerIndex(const type* keys, const int64_t& count, const type& value,
+                              std::true_type);  // branchless scan for arithmetic keys
+
+    static int64_t lowerIndex(const type* keys, const int64_t& count, const type& value,
+                              std::false_type);  // binary search for other keys
+
+    bool lowerBound(const type& value, const Leaf*& leaf,
+                    int64_t& position) const;  // first element not less than value, false if none
+
+    BNode* insert(BNode* node, const type& value, type& separator);  // returns new right sibling on split
+
+    bool erase(BNode* node, const type& value);  // remove one element equal to value from the subtree
+
+    void fixChild(Inner* node, const int64_t& index);  // refill child index that has too few keys
+
+    void mergeChildren(Inner* node, const int64_t& index);  // merge child index + 1 into child index
+
+    static void freeNodes(BNode* node);  // free subtree
+
+    void printNode(const BNode* node, int64_t depth, std::ostream& stream) const;
+
+    BNode* root = nullptr;  // pointer to the root of the tree
+    int64_t size = 0;  // current size of the tree
+    int64_t height = 0;  // number of levels
+};
+
+template<typename type, int64_t capacity>
+BTree<type, capacity>::BTree(const type& value) {
+    try {
+        add(value);
+    } catch (...) {
+        std::cout << "\nConstruct threw except\n";
+    }
+}
+
+template<typename type, int64_t capacity>
+BTree<type, capacity>::~BTree() {
+    freeNodes(root);
+}
+
+template<typename type, int64_t capacity>
+void BTree<type, capacity>::freeNodes(BNode* node) {
+    if (node == nullptr) {
+        return;
+    }
+    if (node->leaf) {
+        delete static_cast<Leaf*>(node);
+        return;
+    }
+
+    Inner* inner = static_cast<Inner*>(node);
+
+    for (int64_t i = 0; i <= inner->count; ++i) {
+        freeNodes(inner->children[i]);
+    }
+    delete inner;
+}
+
+template<typename type, int64_t capacity>
+int64_t BTree<type, capacity>::lowerIndex(const type* keys, const int64_t& count, const type& value) {
+    return lowerIndex(keys, count, value, std::is_arithmetic<type>());
+}
+
+template<typename type, int64_t capacity>
+int64_t BTree<type, capacity>::lowerIndex(const type* keys, const int64_t& count, const type& value,
+                                          std::true_type) {
+    int64_t index = 0;
+
+    for (int64_t i = 0; i < count; ++i) {  // keys are sorted, so counting the smaller ones finds the position
+        index += (keys[i] < value);
+    }
+    return index;
+}
+
+template<typename type, int64_t capacity>
+int64_t BTree<type, capacity>::lowerIndex(const type* keys, const int64_t& count, const type& value,
+                                          std::false_type) {
+    return std::lower_bound(keys, keys + count, value) - keys;
+}
+
+template<typename type, int64_t capacity>
+bool BTree<type, capacity>::lowerBound(const type& value, const Leaf*& leaf, int64_t& position) const {
+    const BNode* node = root;
+
+    if (node == nullptr) {
+        return false;
+    }
+    while (!node->leaf) {
+        const Inner* inner = static_cast<const Inner*>(node);
+
+        node = inner->children[lowerIndex(inner->keys, inner->count, value)];
+    }
+    leaf = static_cast<const Leaf*>(node);
+    position = lowerIndex(leaf->keys, leaf->count, value);
+    if (position == leaf->count) {  // every key here is less, the answer starts the next leaf
+        leaf = leaf->next;
+        position = 0;
+    }
+    return leaf != nullptr;
+}
+
+template<typename type, int64_t capacity>
+bool BTree<type, capacity>::find(const type& value) const {
+    const Leaf* leaf = nullptr;
+    int64_t position = 0;
+
+    return lowerBound(value, leaf, position) && !(value < leaf->keys[position]);
+}
+
+template<typename type, int64_t capacity>
+type BTree<type, capacity>::findMin() const {
+    const BNode* node = root;
+
+    if (node == nullptr) {
+        return type();
+    }
+    while (!node->leaf) {
+        node = static_cast<const Inner*>(node)->children[0];
+    }
+    return node->keys[0];
+}
+
+template<typename type, int64_t capacity>
+type BTree<type, capacity>::findMax() const {
+    const BNode* node = root;
+
+    if (node == nullptr) {
+        return type();
+    }
+    while (!node->leaf) {
+        node = static_cast<const Inner*>(node)->children[node->count];
+    }
+    return node->keys[node->count - 1];
+}
+
+template<typename type, int64_t capacity>
+typename BTree<type, capacity>::BNode* BTree<type, capacity>::insert(BNode* node, const type& value,
+                                                                      type& separator) {
+    int64_t half = (capacity + 1) / 2;  // keys left in node after the split
+
+    if (node->leaf) {
+        Leaf* leaf = static_cast<Leaf*>(node);
+        int64_t position = std::upper_bound(leaf->keys, leaf->keys + leaf->count, value) - leaf->keys;
+
+        if (leaf->count < capacity) {
+            std::move_backward(leaf->keys + position, leaf->keys + leaf->count, leaf->keys + leaf->count + 1);
+            leaf->keys[position] = value;
+            ++leaf->count;
+            return nullptr;
+        }
+
+        Leaf* right = new Leaf();
+        type keys[capacity + 1];  // keys of the full leaf with the new one, before the split
+
+        std::move(leaf->keys, leaf->keys + position, keys);
+        keys[position] = value;
+        std::move(leaf->keys + position, leaf->keys + capacity, keys + position + 1);
+        std::move(keys, keys + half, leaf->keys);
+        std::move(keys + half, keys + capacity + 1, right->keys);
+        leaf->count = half;
+        right->count = capacity + 1 - half;
+        right->next = leaf->next;
+        leaf->next = right;
+        separator = right->keys[0];
+        return right;
+    }
+
+    Inner* inner = static_cast<Inner*>(node);
+    int64_t index = std::upper_bound(inner->keys, inner->keys + inner->count, value) - inner->keys;
+    type child_separator;
+    BNode* child = insert(inner->children[index], value, child_separator);
+
+    if (child == nullptr) {
+        return nullptr;
+    }
+    if (inner->count < capacity) {
+        std::move_backward(inner->keys + index, inner->keys + inner->count, inner->keys + inner->count + 1);
+        std::move_backward(inner->children + index + 1, inner->children + inner->count + 1,
+                           inner->children + inner->count + 2);
+        inner->keys[index] = std::move(child_separator);
+        inner->children[index + 1] = child;
+        ++inner->count;
+        return nullptr;
+    }
+
+    Inner* right = new Inner();
+    type keys[capacity + 1];  // keys of the full node with the new one, before the split
+    BNode* children[capacity + 2];
+
+    std::move(inner->keys, inner->keys + index, keys);
+    keys[index] = std::move(child_separator);
+    std::move(inner->keys + index, inner->keys + capacity, keys + index + 1);
+    std::copy(inner->children, inner->children + index + 1, children);
+    children[index + 1] = child;
+    std::copy(inner->children + index + 1, inner->children + capacity + 1, children + index + 2);
+
+    std::move(keys, keys + half, inner->keys);  // keys[half] moves up to the parent
+    std::copy(children, children + half + 1, inner->children);
+    std::move(keys + half + 1, keys + capacity + 1, right->keys);
+    std::copy(children + half + 1, children + capacity + 2, right->children);
+    inner->count = half;
+    right->count = capacity - half;
+    separator = std::move(keys[half]);
+    return right;
+}
+
+template<typename type, int64_t capacity>
+void BTree<type, capacity>::add(const type& value) {
+    try {
+        type separator;
+
+        if (root == nullptr) {
+            root = new Leaf();
+            height = 1;
+        }
+
+        BNode* right = insert(root, value, separator);
+
+        if (right != nullptr) {  // the root was split, the tree grows by one level
+            Inner* new_root = new Inner();
+
+            new_root->keys[0] = std::move(separator);
+            new_root->children[0] = root;
+            new_root->children[1] = right;
+            new_root->count = 1;
+            root = new_root;
+            ++height;
+        }
+        ++size;
+    } catch (...) {
+        std::cout << "\nAdd method threw except\n";
+    }
+}
+
+template<typename type, int64_t capacity>
+void BTree<type, capacity>::mergeChildren(Inner* node, const int64_t& index) {
+    BNode* left = node->children[index];
+    BNode* right = node->children[index + 1];
+
+    if (left->leaf) {
+        std::move(right->keys, right->keys + right->count, left->keys + left->count);
+        static_cast<Leaf*>(left)->next = static_cast<Leaf*>(right)->next;
+        left->count += right->count;
+        delete static_cast<Leaf*>(right);
+    } else {
+        Inner* inner_left = static_cast<Inner*>(left);
+        Inner* inner_right = static_cast<Inner*>(right);
+
+        inner_left->keys[inner_left->count] = std::move(node->keys[index]);
+        std::move(inner_right->keys, inner_right->keys + inner_right->count,
+                  inner_left->keys + inner_left->count + 1);
+        std::copy(inner_right->children, inner_right->children + inner_right->count + 1,
+                  inner_left->children + inner_left->count + 1);
+        inner_left->count += inner_right->count + 1;
+        delete inner_right;
+    }
+    std::move(node->keys + index + 1, node->keys + node->count, node->keys + index);
+    std::copy(node->children + index + 2, node->children + node->count + 1, node->children + index + 1);
+    --node->count;
+}
+
+template<typename type, int64_t capacity>
+void BTree<type, capacity>::fixChild(Inner* node, const int64_t& index) {
+    BNode* child = node->children[index];
+    BNode* left = (index > 0) ? node->children[index - 1] : nullptr;
+    BNode* right = (index < node->count) ? node->children[index + 1] : nullptr;
+
+    if ((left != nullptr) && (left->count > min_keys)) {  // borrow the last key of the left sibling
+        std::move_backward(child->keys, child->keys + child->count, child->keys + child->count + 1);
+        if (child->leaf) {
+            child->keys[0] = std::move(left->keys[left->count - 1]);
+            node->keys[index - 1] = child->keys[0];
+        } else {
+            Inner* inner_child = static_cast<Inner*>(child);
+            Inner* inner_left = static_cast<Inner*>(left);
+
+            std::copy_backward(inner_child->children, inner_child->children + child->count + 1,
+                               inner_child->children + child->count + 2);
+            inner_child->keys[0] = std::move(node->keys[index - 1]);
+            inner_child->children[0] = inner_left->children[left->count];
+            node->keys[index - 1] = std::move(left->keys[left->count - 1]);
+        }
+        ++child->count;
+        --left->count;
+    } else if ((right != nullptr) && (right->count > min_keys)) {  // borrow the first key of the right sibling
+        if (child->leaf) {
+            child->keys[child->count] = std::move(right->keys[0]);
+            std::move(right->keys + 1, right->keys + right->count, right->keys);
+            node->keys[index] = right->keys[0];
+        } else {
+            Inner* inner_child = static_cast<Inner*>(child);
+            Inner* inner_right = static_cast<Inner*>(right);
+
+            inner_child->keys[child->count] = std::move(node->keys[index]);
+            inner_child->children[child->count + 1] = inner_right->children[0];
+            node->keys[index] = std::move(right->keys[0]);
+            std::move(right->keys + 1, right->keys + right->count, right->keys);
+            std::copy(inner_right->children + 1, inner_right->children + right->count + 1,
+                      inner_right->children);
+        }
+        ++child->count;
+        --right->count;
+    } else if (left != nullptr) {
+        mergeChildren(node, index - 1);
+    } else {
+        mergeChildren(node, index);
+    }
+}
+
+template<typename type, int64_t capacity>
+bool BTree<type, capacity>::erase(BNode* node, const type& value) {
+    if (node->leaf) {
+        int64_t position = lowerIndex(node->keys, node->count, value);
+
+        if ((position == node->count) || (value < node->keys[position])) {
+            return false;
+        }
+        std::move(node->keys + position + 1, node->keys + node->count, node->keys + position);
+        --node->count;
+        return true;
+    }
+
+    Inner* inner = static_cast<Inner*>(node);
+    int64_t index = lowerIndex(inner->keys, inner->count, value);
+    bool removed = erase(inner->children[index], value);
+
+    if (!removed && (index < inner->count) && !(value < inner->keys[index])) {
+        ++index;  // equal elements may start right after the separator
+        removed = erase(inner->children[index], value);
+    }
+    if (removed && (inner->children[index]->count < min_keys)) {
+        fixChild(inner, index);
+    }
+    return removed;
+}
+
+template<typename type, int64_t capacity>
+void BTree<type, capacity>::remove(const type& value) {
+    if ((root == nullptr) || !erase(root, value)) {
+        return;
+    }
+    --size;
+    if (root->count == 0) {  // the root lost its last key, the tree shrinks by one level
+        BNode* old_root = root;
+
+        if (root->leaf) {
+            root = nullptr;
+            delete static_cast<Leaf*>(old_root);
+        } else {
+            root = static_cast<Inner*>(old_root)->children[0];
+            delete static_cast<Inner*>(old_root);
+        }
+        --height;
+    }
+}
+
+template<typename type, int64_t capacity>
+template<typename function>
+void BTree<type, capacity>::rangeForEach(const type& low, const type& high, function fn) const {
+    const Leaf* leaf = nullptr;
+    int64_t position = 0;
+
+    if ((high < low) || !lowerBound(low, leaf, position)) {
+        return;
+    }
+    for (; leaf != nullptr; leaf = leaf->next, position = 0) {
+        for (; position < leaf->count; ++position) {
+            if (high < leaf->keys[position]) {
+                return;
+            }
+            fn(leaf->keys[position]);
+        }
+    }
+}
+
+template<typename type, int64_t capacity>
+bool BTree<type, capacity>::isClear() const {
+    return root == nullptr;
+}
+
+template<typename type, int64_t capacity>
+void BTree<type, capacity>::clear() {
+    freeNodes(root);
+    root = nullptr;
+    size = 0;
+    height = 0;
+}
+
+template<typename type, int64_t capacity>
+int64_t BTree<type, capacity>::getSize() const {
+    return size;
+}
+
+template<typename type, int64_t capacity>
+int64_t BTree<type, capacity>::getHeight() const {
+    return height;
+}
+
+template<typename type, int64_t capacity>
+void BTree<type, capacity>::printNode(const BNode* node, int64_t depth, std::ostream& stream) const {
+    for (int64_t i = depth; i > 0; --i) {
+        stream << "    ";
+    }
+    stream << "[";
+    for (int64_t i = 0; i < node->count; ++i) {
+        stream << ((i == 0) ? "" : " ") << node->keys[i];
+    }
+    stream << "]\n";
+    if (!node->leaf) {
+        const Inner* inner = static_cast<const Inner*>(node);
+
+        for (int64_t i = 0; i <= node->count; ++i) {
+            printNode(inner->children[i], depth + 1, stream);
+        }
+    }
+}
+
+template<typename type, int64_t capacity>
+std::ostream& operator<<(std::ostream& stream,
+                         const BTree<type, capacity>& tree) {
+    if (tree.isClear()) {
+        stream << "Tree is clear!\n";
+    } else {
+        tree.printNode(tree.root, 0, stream);
+    }
+    return stream;
+}
@@ -0,0 +1,305 @@
+// Copyright 2023 binoll
+#pragma once
+
+#include "../../libs.hpp"
+
+template<typename type>
+class FrozenTree;
+
+template<typename type>
+class FrozenIterator {  // bidirectional in-order iterator
+ public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const type*;
+    using reference = const type&;
+
+    FrozenIterator() = default;  // constructor without parameters
+
+    FrozenIterator(const FrozenTree<type>* tree, const int64_t& index);  // constructor with parameters
+
+    const type& operator*() const;  // value of the element
+
+    const type* operator->() const;  // pointer to the value of the element
+
+    FrozenIterator<type>& operator++();  // go to the next element in order
+
+    FrozenIterator<type> operator++(int);  // go to the next element in order
+
+    FrozenIterator<type>& operator--();  // go to the previous element in order
+
+    FrozenIterator<type> operator--(int);  // go to the previous element in order
+
+    bool operator==(const FrozenIterator<type>& iterator) const;  // for comparison
+
+    bool operator!=(const FrozenIterator<type>& iterator) const;  // for comparison
+
+ private:
+    const FrozenTree<type>* tree = nullptr;  // tree of the element
+    int64_t index = 0;  // position in the layout, 0 for end
+};
+
+// Read-only search tree stored in one array in Eytzinger (BFS) order: the
+// children of the element at index k sit at 2k and 2k + 1, so there are no
+// pointers and the top levels share a few cache lines. A lookup goes down
+// without a branch on the comparison and prefetches the descendants as many
+// levels ahead as fit one cache line (16 of them four levels down for 4-byte
+// keys), so the memory latency of the lower levels overlaps with the work on
+// the upper ones. Built once from sorted input,
+// for example by freeze() of BinarySearchTree or AVLSearchTree.
+template<typename type>
+class FrozenTree {
+ public:
+    FrozenTree() = default;  // constructor without parameters
+
+    template<typename iterator>
+    FrozenTree(iterator first, iterator last);  // constructor from a sorted range
+
+    ~FrozenTree() = default;  // destructor
+
+    bool find(const type& value) const;  // searching for an element
+
+    type findMin() const;  // return min element
+
+    type findMax() const;  // return max element
+
+    bool isClear() const;  // checking for emptiness
+
+    int64_t getSize() const;  // returns the size of tree
+
+    FrozenIterator<type> begin() const;  // iterator to the min element
+
+    FrozenIterator<type> end() const;  // iterator past the max element
+
+    FrozenIterator<type> lowerBound(const type& value) const;  // first element not less than value
+
+    FrozenIterator<type> upperBound(const type& value) const;  // first element greater than value
+
+    template<typename function>
+    void rangeForEach(const type& low, const type& high, function fn) const;  // call fn for elements in [low, high]
+
+    template<typename new_type>
+    friend std::ostream& operator<<(std::ostream& stream,
+                                    const FrozenTree<new_type>& tree);  // print
+
+    friend class FrozenIterator<type>;
+
+ private:
+    template<typename iterator>
+    void fill(const int64_t& index, iterator& it);  // place the sorted input in order
+
+    void prefetch(const int64_t& index) const;  // prefetch the block of descendants prefetch_levels below
+
+    int64_t leftmost(int64_t index) const;  // min element of the subtree
+
+    int64_t rightmost(int64_t index) const;  // max element of the subtree
+
+    static int64_t climb(const int64_t& index);  // undo the descent to the last element that went left
+
+    static constexpr int64_t prefetch_levels = (sizeof(type) <= 4) ? 4 : (sizeof(type) <= 8) ? 3 :
+                                               (sizeof(type) <= 16) ? 2 : 1;  // levels whose block fits a cache line
+
+    static constexpr int64_t prefetch_block = int64_t(1) << prefetch_levels;  // descendants prefetch_levels below
+
+    std::vector<type> data;  // elements in Eytzinger order from index 1
+    int64_t size = 0;  // number of elements
+};
+
+template<typename type>
+template<typename iterator>
+FrozenTree<type>::FrozenTree(iterator first, iterator last) {
+    try {
+        size = static_cast<int64_t>(std::distance(first, last));
+        data.resize(size + 1);
+        fill(1, first);
+    } catch (...) {
+        data.clear();
+        size = 0;
+        std::cout << "\nConstruct threw except\n";
+    }
+}
+
+template<typename type>
+template<typename iterator>
+void FrozenTree<type>::fill(const int64_t& index, iterator& it) {
+    if (index > size) {
+        return;
+    }
+    fill(2 * index, it);
+    data[index] = *it;
+    ++it;
+    fill(2 * index + 1, it);
+}
+
+template<typename type>
+void FrozenTree<type>::prefetch(const int64_t& index) const {
+    // the block is at most one line of small keys, which may straddle two lines, or
+    // two large elements, whose keys start in their first lines
+    __builtin_prefetch(data.data() + std::min(prefetch_block * index, size));
+    __builtin_prefetch(data.data() + std::min(prefetch_block * index + prefetch_block - 1, size));
+}
+
+template<typename type>
+int64_t FrozenTree<type>::climb(const int64_t& index) {
+    return index >> __builtin_ffsll(~index);  // drop the trailing right steps and one left step
+}
+
+template<typename type>
+int64_t FrozenTree<type>::leftmost(int64_t index) const {
+    while (2 * index <= size) {
+        index *= 2;
+    }
+    return index;
+}
+
+template<typename type>
+int64_t FrozenTree<type>::rightmost(int64_t index) const {
+    while (2 * index + 1 <= size) {
+        index = 2 * index + 1;
+    }
+    return index;
+}
+
+template<typename type>
+FrozenIterator<type> FrozenTree<type>::lowerBound(const type& value) const {
+    int64_t index = 1;
+
+    while (index <= size) {
+        prefetch(index);
+        index = 2 * index + (data[index] < value);
+    }
+    return FrozenIterator<type>(this, climb(index));
+}
+
+template<typename type>
+FrozenIterator<type> FrozenTree<type>::upperBound(const type& value) const {
+    int64_t index = 1;
+
+    while (index <= size) {
+        prefetch(index);
+        index = 2 * index + !(value < data[index]);
+    }
+    return FrozenIterator<type>(this, climb(index));
+}
+
+template<typename type>
+bool FrozenTree<type>::find(const type& value) const {
+    FrozenIterator<type> it = lowerBound(value);
+
+    return (it != end()) && !(value < *it);
+}
+
+template<typename type>
+type FrozenTree<type>::findMin() const {
+    return (size == 0) ? type() : data[leftmost(1)];
+}
+
+template<typename type>
+type FrozenTree<type>::findMax() const {
+    return (size == 0) ? type() : data[rightmost(1)];
+}
+
+template<typename type>
+bool FrozenTree<type>::isClear() const {
+    return size == 0;
+}
+
+template<typename type>
+int64_t FrozenTree<type>::getSize() const {
+    return size;
+}
+
+template<typename type>
+FrozenIterator<type> FrozenTree<type>::begin() const {
+    return FrozenIterator<type>(this, (size == 0) ? 0 : leftmost(1));
+}
+
+template<typename type>
+FrozenIterator<type> FrozenTree<type>::end() const {
+    return FrozenIterator<type>(this, 0);
+}
+
+template<typename type>
+template<typename function>
+void FrozenTree<type>::rangeForEach(const type& low, const type& high, function fn) const {
+    for (FrozenIterator<type> it = lowerBound(low); (it != end()) && !(high < *it); ++it) {
+        fn(*it);
+    }
+}
+
+template<typename type>
+std::ostream& operator<<(std::ostream& stream,
+                         const FrozenTree<type>& tree) {
+    if (tree.isClear()) {
+        stream << "Tree is clear!\n";
+    } else {
+        for (const type& value : tree) {
+            stream << value << " ";
+        }
+        stream << "\n";
+    }
+    return stream;
+}
+
+template<typename type>
+FrozenIterator<type>::FrozenIterator(const FrozenTree<type>* tree,
+                                     const int64_t& index) : tree(tree), index(index) {}
+
+template<typename type>
+const type& FrozenIterator<type>::operator*() const {
+    return tree->data[index];
+}
+
+template<typename type>
+const type* FrozenIterator<type>::operator->() const {
+    return &tree->data[index];
+}
+
+template<typename type>
+FrozenIterator<type>& FrozenIterator<type>::operator++() {
+    if (2 * index + 1 <= tree->size) {
+        index = tree->leftmost(2 * index + 1);
+    } else {
+        index = FrozenTree<type>::climb(index);
+    }
+    return *this;
+}
+
+template<typename type>
+FrozenIterator<type> FrozenIterator<type>::operator++(int) {
+    FrozenIterator<type> temp = *this;
+
+    ++(*this);
+    return temp;
+}
+
+template<typename type>
+FrozenIterator<type>& FrozenIterator<type>::operator--() {
+    if (index == 0) {  // step back from end
+        index = tree->rightmost(1);
+    } else if (2 * index <= tree->size) {
+        index = tree->rightmost(2 * index);
+    } else {
+        index >>= __builtin_ffsll(index);  // drop the trailing left steps and one right step
+    }
+    return *this;
+}
+
+template<typename type>
+FrozenIterator<type> FrozenIterator<type>::operator--(int) {
+    FrozenIterator<type> temp = *this;
+
+    --(*this);
+    return temp;
+}
+
+template<typename type>
+bool FrozenIterator<type>::operator==(const FrozenIterator<type>& iterator) const {
+    return index == iterator.index;
+}
+
+template<typename type>
+bool FrozenIterator<type>::operator!=(const FrozenIterator<type>& iterator) const {
+    return index != iterator.index;
+}
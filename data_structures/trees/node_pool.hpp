@@ -0,0 +1,187 @@
+// Copyright 2023 binoll
+#pragma once
+
+#include "../../libs.hpp"
+
+using NodeIndex = uint32_t;  // handle of a node in a NodePool
+
+enum : NodeIndex { no_node = 0 };  // index of no node, never handed out
+
+// Arena for tree nodes with 32-bit handles. All nodes sit in one array that
+// doubles like a vector when it is full, so a handle turns into an address with
+// one multiply-add and links between nodes are 4-byte indices instead of 8-byte
+// pointers. Removed nodes go to a free list and are reused by the next
+// allocation. Growing moves the nodes, so a reference returned by operator[] is
+// only valid until the next allocate. release() drops the array at once without
+// running the node destructors.
+template<typename node>
+class NodePool {
+ public:
+    NodePool() = default;  // constructor without parameters
+
+    NodePool(const NodePool<node>& pool) = delete;
+
+    NodePool<node>& operator=(const NodePool<node>& pool) = delete;
+
+    ~NodePool();  // destructor, the nodes must already be destroyed
+
+    template<typename... arguments>
+    NodeIndex allocate(arguments&&... args);  // construct node in the pool, return its index
+
+    void deallocate(const NodeIndex& index);  // destroy node and put its slot to the free list
+
+    node& operator[](const NodeIndex& index);  // live node with the index
+
+    const node& operator[](const NodeIndex& index) const;  // live node with the index
+
+    void release();  // free the array at once, live nodes are not destroyed
+
+    int64_t getSize() const;  // return number of live nodes
+
+ private:
+    union Slot {
+        NodeIndex next;  // next free slot
+        typename std::aligned_storage<sizeof(node), alignof(node)>::type storage;  // memory of the node
+    };
+
+    void moveTo(Slot* fresh);  // move the live nodes to a larger array
+
+    Slot* slots = nullptr;  // slot 0 is never used
+    NodeIndex free_list = no_node;  // slots of removed nodes
+    int64_t capacity = 0;  // slots in the array
+    int64_t unused = 1;  // first index never handed out
+    int64_t size = 0;  // live nodes
+};
+
+template<typename node>
+NodePool<node>::~NodePool() {
+    release();
+}
+
+template<typename node>
+void NodePool<node>::moveTo(Slot* fresh) {
+    if (std::is_trivially_copyable<node>::value) {
+        if (unused > 1) {
+            std::memcpy(fresh + 1, slots + 1, (unused - 1) * sizeof(Slot));
+        }
+        return;
+    }
+
+    std::vector<bool> is_free(unused, false);
+    int64_t index = 1;
+
+    for (NodeIndex slot = free_list; slot != no_node; slot = slots[slot].next) {
+        is_free[slot] = true;
+    }
+    try {
+        for (; index < unused; ++index) {
+            if (is_free[index]) {
+                fresh[index].next = slots[index].next;
+            } else {
+                new (&fresh[index].storage) node(std::move_if_noexcept((*this)[index]));
+            }
+        }
+    } catch (...) {
+        while (--index > 0) {
+            if (!is_free[index]) {
+                reinterpret_cast<node*>(&fresh[index].storage)->~node();
+            }
+        }
+        throw;
+    }
+    for (index = 1; index < unused; ++index) {
+        if (!is_free[index]) {
+            (*this)[index].~node();
+        }
+    }
+}
+
+template<typename node>
+template<typename... arguments>
+NodeIndex NodePool<node>::allocate(arguments&&... args) {
+    if (free_list != no_node) {
+        NodeIndex index = free_list;
+        NodeIndex next = slots[index].next;
+
+        try {
+            new (&slots[index].storage) node(std::forward<arguments>(args)...);
+        } catch (...) {
+            slots[index].next = next;
+            throw;
+        }
+        free_list = next;
+        ++size;
+        return index;
+    }
+
+    Slot* array = slots;
+    int64_t new_capacity = capacity;
+
+    if (unused >= capacity) {  // full, or unused is 1 before the first array
+        new_capacity = std::min(std::max<int64_t>(16, 2 * capacity),
+                                int64_t(std::numeric_limits<NodeIndex>::max()) + 1);
+        if (new_capacity == capacity) {
+            throw std::length_error("NodePool");
+        }
+        array = static_cast<Slot*>(::operator new(new_capacity * sizeof(Slot)));
+    }
+    try {
+        // args may point into the old array, so the node is built before the others move
+        new (&array[unused].storage) node(std::forward<arguments>(args)...);
+    } catch (...) {
+        if (array != slots) {
+            ::operator delete(array);
+        }
+        throw;
+    }
+    if (array != slots) {
+        try {
+            moveTo(array);
+        } catch (...) {
+            reinterpret_cast<node*>(&array[unused].storage)->~node();
+            ::operator delete(array);
+            throw;
+        }
+        ::operator delete(slots);
+        slots = array;
+        capacity = new_capacity;
+    }
+    ++size;
+    return static_cast<NodeIndex>(unused++);
+}
+
+template<typename node>
+void NodePool<node>::deallocate(const NodeIndex& index) {
+    if (index == no_node) {
+        return;
+    }
+    (*this)[index].~node();
+    slots[index].next = free_list;
+    free_list = index;
+    --size;
+}
+
+template<typename node>
+node& NodePool<node>::operator[](const NodeIndex& index) {
+    return *reinterpret_cast<node*>(&slots[index].storage);
+}
+
+template<typename node>
+const node& NodePool<node>::operator[](const NodeIndex& index) const {
+    return *reinterpret_cast<const node*>(&slots[index].storage);
+}
+
+template<typename node>
+void NodePool<node>::release() {
+    ::operator delete(slots);
+    slots = nullptr;
+    free_list = no_node;
+    capacity = 0;
+    unused = 1;
+    size = 0;
+}
+
+template<typename node>
+int64_t NodePool<node>::getSize() const {
+    return size;
+}
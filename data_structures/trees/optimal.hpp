@@ -2,13 +2,365 @@
 #pragma once
 
 #include "../../libs.hpp"
+#include "node_pool.hpp"
+
+// Dynamic programming table of the optimal tree over the intervals (i, j),
+// 0 <= i <= j <= n, where (i, j) holds the keys i + 1 .. j. The triangle is
+// stored row after row in one array of costs and one array of 32-bit roots.
+// Interval weights come from prefix sums of the frequencies and are not
+// stored, and releaseCosts() frees the costs once the table is filled, so
+// building the tree needs only the roots. With several threads the table is
+// cut into square tiles: a tile needs only the tiles left of it and below it,
+// so the tiles of one tile diagonal are filled in parallel, each of them row
+// after row as in the serial build.
+class OptimalTable {
+ public:
+    OptimalTable(const int64_t* successful_frequency, const int64_t& count,
+                 const int64_t* unsuccessful_frequency);  // constructor, allocates the table
+
+    void compute(const int64_t& threads = 1);  // fill the table, in parallel tile diagonals if threads > 1
+
+    void releaseCosts();  // free the costs, only the roots are kept
+
+    int64_t getRoot(const int64_t& i, const int64_t& j) const;  // root key (from 1) of the interval (i, j)
+
+    int64_t getCost() const;  // weighted cost of the optimal tree
+
+    int64_t getCount() const;  // number of keys
+
+    int64_t weight(const int64_t& i, const int64_t& j) const;  // total frequency of the interval (i, j)
 
-struct MatrixElement {
-    int64_t w = 0;
-    int64_t p = 0;
-    int64_t r = 0;
+ private:
+    int64_t index(const int64_t& i, const int64_t& j) const;  // position of (i, j) in the triangle
+
+    void computeCell(const int64_t& i, const int64_t& j);  // cost and root of (i, j) from shorter intervals
+
+    void computeTile(const int64_t& row, const int64_t& column);  // fill one tile row after row from the bottom
+
+    static constexpr int64_t tile_size = 256;  // rows and columns of a tile
+
+    std::vector<int64_t> prefix;  // prefix[j] - prefix[i] is the weight of (i, j) without the first gap
+    std::vector<int64_t> gaps;  // unsuccessful frequencies
+    std::vector<int64_t> costs;  // cost of every interval, its weight included
+    std::vector<int32_t> roots;  // root of every interval
+    int64_t cost = 0;  // cost of (0, n), kept after releaseCosts()
+    int64_t count = 0;  // number of keys
 };
 
+inline OptimalTable::OptimalTable(const int64_t* successful_frequency, const int64_t& count,
+                                  const int64_t* unsuccessful_frequency) : count(count) {
+    if (count < 0 || count >= std::numeric_limits<int32_t>::max()) {
+        throw std::length_error("OptimalTable");
+    }
+    prefix.resize(count + 1);
+    gaps.assign(unsuccessful_frequency, unsuccessful_frequency + count + 1);
+    for (int64_t j = 1; j <= count; ++j) {
+        prefix[j] = prefix[j - 1] + successful_frequency[j - 1] + unsuccessful_frequency[j];
+    }
+    costs.resize(index(count, count) + 1);
+    roots.resize(costs.size());
+}
+
+inline int64_t OptimalTable::index(const int64_t& i, const int64_t& j) const {
+    return i * (count + 1) - i * (i - 1) / 2 + (j - i);
+}
+
+inline int64_t OptimalTable::weight(const int64_t& i, const int64_t& j) const {
+    return gaps[i] + prefix[j] - prefix[i];
+}
+
+inline void OptimalTable::computeCell(const int64_t& i, const int64_t& j) {
+    // Knuth: some optimal root of (i, j) lies between the roots of (i, j - 1) and (i + 1, j),
+    // so the windows of one diagonal overlap only at their ends and the build is O(n^2)
+    int64_t first = std::max<int64_t>(i + 1, roots[index(i, j - 1)]);
+    int64_t last = roots[index(i + 1, j)];
+    const int64_t* left = &costs[index(i, first - 1)];  // costs of (i, k - 1) are contiguous
+    int64_t right = index(first, j);  // costs of (k, j) are one column, the step shrinks by one per row
+    int64_t best = std::numeric_limits<int64_t>::max();
+    int64_t best_root = first;
+
+    for (int64_t k = first; k <= last; ++k) {
+        int64_t sum = left[k - first] + costs[right];
+
+        if (sum < best) {  // strict, so ties keep the leftmost root
+            best = sum;
+            best_root = k;
+        }
+        right += count - k;
+    }
+    costs[index(i, j)] = best + weight(i, j);
+    roots[index(i, j)] = static_cast<int32_t>(best_root);
+}
+
+inline void OptimalTable::computeTile(const int64_t& row, const int64_t& column) {
+    int64_t first_row = row * tile_size;
+    int64_t last_row = std::min(first_row + tile_size, count + 1) - 1;
+    int64_t first_column = column * tile_size;
+    int64_t last_column = std::min(first_column + tile_size, count + 1) - 1;
+
+    for (int64_t i = last_row; i >= first_row; --i) {
+        for (int64_t j = std::max(first_column, i + 1); j <= last_column; ++j) {
+            computeCell(i, j);
+        }
+    }
+}
+
+inline void OptimalTable::compute(const int64_t& threads) {
+    int64_t tiles = count / tile_size + 1;  // tiles in one row of the tiling
+
+    for (int64_t i = 0; i <= count; ++i) {
+        costs[index(i, i)] = gaps[i];
+        roots[index(i, i)] = static_cast<int32_t>(i);
+    }
+    if ((threads <= 1) || (tiles == 1)) {
+        for (int64_t i = count - 1; i >= 0; --i) {  // (i, j) needs only row i left of j and the rows below
+            for (int64_t j = i + 1; j <= count; ++j) {
+                computeCell(i, j);
+            }
+        }
+    } else {
+        // each cell is computed exactly as in the serial build, so the roots do not depend on threads
+        for (int64_t diagonal = 0; diagonal < tiles; ++diagonal) {
+            int64_t size = tiles - diagonal;  // tiles on this diagonal
+            int64_t workers = std::min(threads, size);
+            std::atomic<int64_t> next(0);
+            std::vector<std::future<void>> tasks;
+            auto work = [&]() {
+                for (int64_t row = next++; row < size; row = next++) {
+                    computeTile(row, row + diagonal);
+                }
+            };
+
+            for (int64_t worker = 1; worker < workers; ++worker) {
+                // the policy lets the task run inline when no thread can be started
+                tasks.push_back(std::async(std::launch::async | std::launch::deferred, work));
+            }
+            work();
+            for (auto& task : tasks) {
+                task.get();
+            }
+        }
+    }
+    cost = costs[index(0, count)];
+}
+
+inline void OptimalTable::releaseCosts() {
+    std::vector<int64_t>().swap(costs);
+}
+
+inline int64_t OptimalTable::getRoot(const int64_t& i, const int64_t& j) const {
+    return roots[index(i, j)];
+}
+
+inline int64_t OptimalTable::getCost() const {
+    return cost;
+}
+
+inline int64_t OptimalTable::getCount() const {
+    return count;
+}
+
+// Sequence of weighted items for Garsia-Wachs with O(log n) expected access,
+// insert and erase by position. It is an implicit treap: a node is ordered by
+// the number of items before it, and also keeps the max weight of its subtree,
+// so the last item at least as heavy as a value before a position is found by
+// one split and one descent. Erased nodes are reused by the next insert.
+class WeightSequence {
+ public:
+    explicit WeightSequence(const int64_t& capacity);  // constructor, reserves capacity items
+
+    int64_t getSize() const;  // number of items
+
+    int64_t getWeight(const int64_t& position) const;  // weight of the item at position
+
+    int64_t getId(const int64_t& position) const;  // id of the item at position
+
+    void insert(const int64_t& position, const int64_t& weight, const int64_t& id);  // new item at position
+
+    void erase(const int64_t& position);  // remove the item at position
+
+    int64_t lastAtLeast(const int64_t& end, const int64_t& value);  // last position before end with weight >= value, or -1
+
+ private:
+    struct Item {
+        int64_t weight;
+        int64_t id;
+        int64_t max;  // max weight in the subtree
+        uint32_t priority;  // heap order of the treap
+        int32_t left;
+        int32_t right;
+        int32_t count;  // items in the subtree
+    };
+
+    int32_t find(int64_t position) const;  // node of the item at position
+
+    int32_t countOf(const int32_t& node) const;  // items in the subtree
+
+    void update(const int32_t& node);  // count and max from the children
+
+    void split(int32_t node, int64_t count, int32_t& left, int32_t& right);  // first count items go to left
+
+    int32_t join(int32_t left, int32_t right);  // left items before right items
+
+    std::vector<Item> items;  // nodes of the treap
+    std::vector<int32_t> free_items;  // erased nodes
+    int32_t root = -1;  // -1 is no node
+    uint32_t random = 2463534242u;  // xorshift state for the priorities
+};
+
+inline WeightSequence::WeightSequence(const int64_t& capacity) {
+    if (capacity >= std::numeric_limits<int32_t>::max()) {
+        throw std::length_error("WeightSequence");
+    }
+    items.reserve(capacity);
+}
+
+inline int64_t WeightSequence::getSize() const {
+    return countOf(root);
+}
+
+inline int32_t WeightSequence::countOf(const int32_t& node) const {
+    return (node == -1) ? 0 : items[node].count;
+}
+
+inline void WeightSequence::update(const int32_t& node) {
+    Item& item = items[node];
+
+    item.count = countOf(item.left) + countOf(item.right) + 1;
+    item.max = item.weight;
+    if (item.left != -1) {
+        item.max = std::max(item.max, items[item.left].max);
+    }
+    if (item.right != -1) {
+        item.max = std::max(item.max, items[item.right].max);
+    }
+}
+
+inline int32_t WeightSequence::find(int64_t position) const {
+    int32_t node = root;
+
+    while (true) {
+        int64_t left = countOf(items[node].left);
+
+        if (position < left) {
+            node = items[node].left;
+        } else if (position == left) {
+            return node;
+        } else {
+            position -= left + 1;
+            node = items[node].right;
+        }
+    }
+}
+
+inline int64_t WeightSequence::getWeight(const int64_t& position) const {
+    return items[find(position)].weight;
+}
+
+inline int64_t WeightSequence::getId(const int64_t& position) const {
+    return items[find(position)].id;
+}
+
+inline void WeightSequence::split(int32_t node, int64_t count, int32_t& left, int32_t& right) {
+    if (node == -1) {
+        left = -1;
+        right = -1;
+        return;
+    }
+
+    int64_t left_count = countOf(items[node].left);
+
+    if (left_count < count) {
+        split(items[node].right, count - left_count - 1, items[node].right, right);
+        left = node;
+    } else {
+        split(items[node].left, count, left, items[node].left);
+        right = node;
+    }
+    update(node);
+}
+
+inline int32_t WeightSequence::join(int32_t left, int32_t right) {
+    if (left == -1) {
+        return right;
+    }
+    if (right == -1) {
+        return left;
+    }
+    if (items[left].priority > items[right].priority) {
+        int32_t joined = join(items[left].right, right);
+
+        items[left].right = joined;
+        update(left);
+        return left;
+    }
+
+    int32_t joined = join(left, items[right].left);
+
+    items[right].left = joined;
+    update(right);
+    return right;
+}
+
+inline void WeightSequence::insert(const int64_t& position, const int64_t& weight, const int64_t& id) {
+    int32_t node = 0;
+    int32_t left = -1;
+    int32_t right = -1;
+
+    random ^= random << 13;
+    random ^= random >> 17;
+    random ^= random << 5;
+    if (free_items.empty()) {
+        node = static_cast<int32_t>(items.size());
+        items.push_back({weight, id, weight, random, -1, -1, 1});
+    } else {
+        node = free_items.back();
+        free_items.pop_back();
+        items[node] = {weight, id, weight, random, -1, -1, 1};
+    }
+    split(root, position, left, right);
+    root = join(join(left, node), right);
+}
+
+inline void WeightSequence::erase(const int64_t& position) {
+    int32_t left = -1;
+    int32_t middle = -1;
+    int32_t right = -1;
+
+    split(root, position, left, right);
+    split(right, 1, middle, right);
+    free_items.push_back(middle);
+    root = join(left, right);
+}
+
+inline int64_t WeightSequence::lastAtLeast(const int64_t& end, const int64_t& value) {
+    int32_t left = -1;
+    int32_t right = -1;
+    int64_t result = -1;
+
+    split(root, end, left, right);
+    if ((left != -1) && (items[left].max >= value)) {  // go right whenever the right subtree has a heavy item
+        int32_t node = left;
+        int64_t offset = 0;
+
+        while (true) {
+            int32_t next = items[node].right;
+
+            if ((next != -1) && (items[next].max >= value)) {
+                offset += countOf(items[node].left) + 1;
+                node = next;
+            } else if (items[node].weight >= value) {
+                result = offset + countOf(items[node].left);
+                break;
+            } else {
+                node = items[node].left;
+            }
+        }
+    }
+    root = join(left, right);
+    return result;
+}
+
 template<typename type>
 class TreeNode {
  public:
@@ -19,8 +371,8 @@ class TreeNode {
     ~TreeNode() = default;  // destructor
 
     type value = 0;  // value
-    TreeNode<type>* left = nullptr;  // pointer to the left node
-    TreeNode<type>* right = nullptr;  // pointer to the right node
+    NodeIndex left = no_node;  // index of the left node
+    NodeIndex right = no_node;  // index of the right node
 };
 
 template<typename type>
@@ -42,7 +394,18 @@ class BinarySearchTree {
 
     void remove(const type& value);  // delete element
 
-    void buildOptimalTree(const type* arr_value, const int64_t* successful_frequency, const int64_t& first_count, const int64_t* unsuccessful_frequency);  // build optimal
+    void buildOptimalTree(const type* arr_value, const int64_t* successful_frequency, const int64_t& first_count, const int64_t* unsuccessful_frequency,
+                          const int64_t& threads = 1,
+                          const bool& access_order = true);  // build optimal, the tree does not depend on threads
+
+    void buildWeightBalancedTree(const type* arr_value, const int64_t* successful_frequency, const int64_t& first_count,
+                                 const int64_t* unsuccessful_frequency);  // Mehlhorn's bisection in O(n log n), near optimal
+
+    void buildAlphabeticTree(const type* arr_value, const int64_t* successful_frequency, const int64_t& first_count,
+                             const int64_t* unsuccessful_frequency);  // Garsia-Wachs, optimal when all successful frequencies are 0
+
+    int64_t getSearchCost(const int64_t* successful_frequency,
+                          const int64_t* unsuccessful_frequency) const;  // weighted cost of the tree as in buildOptimalTree
 
     void traversalNLR() const;  // tree traversal NRL
 
@@ -61,17 +424,25 @@ class BinarySearchTree {
                                     const BinarySearchTree<new_type>& tree);  // for print
 
  private:
-    void print_NLR(TreeNode<type>* node) const;  // recursive method for traversal NRL
+    void print_NLR(const NodeIndex& node) const;  // recursive method for traversal NRL
+
+    template<typename root_function, typename weight_function>
+    void buildFromRoots(const type* arr_value, const int64_t& count, root_function root_of,
+                        weight_function weight_of, const bool& access_order);  // build keys 1 .. count from the roots of intervals
 
-    void addOptimalTree(MatrixElement** matrix, const type* arr_value, int64_t i, int64_t j);  // add in optimal tree
+    static std::vector<int64_t> alphabeticLevels(const int64_t* weights,
+                                                 const int64_t& count);  // Garsia-Wachs depths of count leaves
 
-    void print_LNR(TreeNode<type>* node) const;  // recursive method for traversal LNR
+    void print_LNR(const NodeIndex& node) const;  // recursive method for traversal LNR
 
-    void print_RNL(TreeNode<type>* node) const;  // recursive method for traversal RNL
+    void print_RNL(const NodeIndex& node) const;  // recursive method for traversal RNL
 
-    void print_tree(const TreeNode<type>* node, int tab, std::ostream& stream) const;  // method for print tree
+    void print_tree(const NodeIndex& node, int tab, std::ostream& stream) const;  // method for print tree
 
-    TreeNode<type>* root = nullptr;  // pointer to the root of the tree
+    void destroy();  // free all nodes in O(n) without recursion
+
+    NodePool<TreeNode<type>> pool;  // storage of the nodes
+    NodeIndex root = no_node;  // index of the root of the tree
     int64_t min_size = std::numeric_limits<int64_t>::min();  // min value
     int64_t max_size = std::numeric_limits<int64_t>::max();  // max value
     int64_t size = 0;  // current capacity of the tree
@@ -84,7 +455,7 @@ template<typename type>
 BinarySearchTree<type>::BinarySearchTree(const type& value) {
     try {
         if (min_size < size < max_size) {
-            root = new TreeNode<type>(value);
+            root = pool.allocate(value);
 
             ++size;
         } else {
@@ -97,22 +468,20 @@ BinarySearchTree<type>::BinarySearchTree(const type& value) {
 
 template<typename type>
 BinarySearchTree<type>::~BinarySearchTree() {
-    while (root != nullptr) {
-        remove(root->value);
-    }
+    destroy();
 }
 
 template<typename type>
 bool BinarySearchTree<type>::find(const type& value) const {
-    TreeNode<type>* ptr = root;
+    NodeIndex ptr = root;
 
-    while (ptr != nullptr) {
-        if (ptr->value == value) {
+    while (ptr != no_node) {
+        if (pool[ptr].value == value) {
             return true;
-        } else if (ptr->value > value) {
-            ptr = ptr->left;
+        } else if (pool[ptr].value > value) {
+            ptr = pool[ptr].left;
         } else {
-            ptr = ptr->right;
+            ptr = pool[ptr].right;
         }
     }
     return false;
@@ -120,42 +489,42 @@ bool BinarySearchTree<type>::find(const type& value) const {
 
 template<typename type>
 type BinarySearchTree<type>::findMin() const {
-    TreeNode<type>* ptr = root;
-    TreeNode<type>* parent_ptr;
+    NodeIndex ptr = root;
+    NodeIndex parent_ptr = no_node;
 
-    if (ptr == nullptr) {
+    if (ptr == no_node) {
         return -1;
     }
-    while (ptr != nullptr) {
+    while (ptr != no_node) {
         parent_ptr = ptr;
-        ptr = ptr->left;
+        ptr = pool[ptr].left;
     }
-    return parent_ptr->value;
+    return pool[parent_ptr].value;
 }
 
 template<typename type>
 type BinarySearchTree<type>::findMax() const {
-    TreeNode<type>* ptr = root;
-    TreeNode<type>* parent_ptr;
+    NodeIndex ptr = root;
+    NodeIndex parent_ptr = no_node;
 
-    if (ptr == nullptr) {
+    if (ptr == no_node) {
         return -1;
     }
-    while (ptr != nullptr) {
+    while (ptr != no_node) {
         parent_ptr = ptr;
-        ptr = ptr->right;
+        ptr = pool[ptr].right;
     }
-    return parent_ptr->value;
+    return pool[parent_ptr].value;
 }
 
 template<typename type>
 void BinarySearchTree<type>::add(const type& value) {
-    TreeNode<type>* ptr = root;
+    NodeIndex ptr = root;
 
     try {
-        if (root == nullptr) {
+        if (root == no_node) {
             if (min_size < size < max_size) {
-                root = new TreeNode<type>(value);
+                root = pool.allocate(value);
 
                 ++size;
             } else {
@@ -164,25 +533,17 @@ void BinarySearchTree<type>::add(const type& value) {
             return;
         }
         while (true) {
-            if (ptr->value > value) {
-                if (ptr->left == nullptr) {
-                    ptr->left = new TreeNode<type>(value);
+            bool is_left = pool[ptr].value > value;
+            NodeIndex next = is_left ? pool[ptr].left : pool[ptr].right;
 
-                    ++size;
-                    break;
-                } else {
-                    ptr = ptr->left;
-                }
-            } else {
-                if (ptr->right == nullptr) {
-                    ptr->right = new TreeNode<type>(value);
+            if (next == no_node) {
+                NodeIndex node = pool.allocate(value);  // may move the nodes, so the link is taken after it
 
-                    ++size;
-                    break;
-                } else {
-                    ptr = ptr->right;
-                }
+                (is_left ? pool[ptr].left : pool[ptr].right) = node;
+                ++size;
+                break;
             }
+            ptr = next;
         }
     } catch (...)  {
         std::cout << "\nAdd method threw except\n";
@@ -191,89 +552,89 @@ void BinarySearchTree<type>::add(const type& value) {
 
 template<typename type>
 void BinarySearchTree<type>::remove(const type& value) {
-    TreeNode<type>* ptr = root;
-    TreeNode<type>* parent_ptr = root;
+    NodeIndex ptr = root;
+    NodeIndex parent_ptr = root;
     bool is_left = true;
 
     if (!find(value)) {
         return;
     }
 
-    while ((ptr != nullptr) &&
-           (ptr->value != value)) {  // search delete element
+    while ((ptr != no_node) &&
+           (pool[ptr].value != value)) {  // search delete element
         parent_ptr = ptr;
 
-        if (ptr->value > value) {
+        if (pool[ptr].value > value) {
             is_left = true;
-            ptr = ptr->left;
+            ptr = pool[ptr].left;
         } else {
             is_left = false;
-            ptr = ptr->right;
+            ptr = pool[ptr].right;
         }
     }
 
-    if (ptr == nullptr) {  // if did not search delete element
+    if (ptr == no_node) {  // if did not search delete element
         return;
     }
 
     try {
-        if ((ptr->left == nullptr) &&
-            (ptr->right == nullptr)) {  // delete if no child
+        if ((pool[ptr].left == no_node) &&
+            (pool[ptr].right == no_node)) {  // delete if no child
             if (ptr == root) {
-                delete root;
-                root = nullptr;
+                pool.deallocate(root);
+                root = no_node;
             } else if (is_left) {
-                delete parent_ptr->left;
-                parent_ptr->left = nullptr;
+                pool.deallocate(pool[parent_ptr].left);
+                pool[parent_ptr].left = no_node;
             } else {
-                delete parent_ptr->right;
-                parent_ptr->right = nullptr;
+                pool.deallocate(pool[parent_ptr].right);
+                pool[parent_ptr].right = no_node;
             }
-        } else if (ptr->right == nullptr) {  // delete if only left child
+        } else if (pool[ptr].right == no_node) {  // delete if only left child
             if (ptr == root) {
-                TreeNode<type>* temp = root;
+                NodeIndex temp = root;
 
-                root = ptr->left;
-                delete temp;
+                root = pool[ptr].left;
+                pool.deallocate(temp);
             } else if (is_left) {
-                parent_ptr->left = ptr->left;
-                delete ptr;
+                pool[parent_ptr].left = pool[ptr].left;
+                pool.deallocate(ptr);
             } else {
-                parent_ptr->right = ptr->left;
-                delete ptr;
+                pool[parent_ptr].right = pool[ptr].left;
+                pool.deallocate(ptr);
             }
-        } else if (ptr->left == nullptr) {  // delete if only right child
+        } else if (pool[ptr].left == no_node) {  // delete if only right child
             if (ptr == root) {
-                TreeNode<type>* temp = root;
+                NodeIndex temp = root;
 
-                root = ptr->right;
-                delete temp;
+                root = pool[ptr].right;
+                pool.deallocate(temp);
             } else if (is_left) {
-                parent_ptr->left = ptr->right;
-                delete ptr;
+                pool[parent_ptr].left = pool[ptr].right;
+                pool.deallocate(ptr);
             } else {
-                parent_ptr->right = ptr->right;
-                delete ptr;
+                pool[parent_ptr].right = pool[ptr].right;
+                pool.deallocate(ptr);
             }
         } else {  // delete if two child
-            TreeNode<type>* successor = ptr;
-            TreeNode<type>* parent_successor = ptr;
-            TreeNode<type>* child_successor = ptr->right;
+            NodeIndex successor = ptr;
+            NodeIndex parent_successor = ptr;
+            NodeIndex child_successor = pool[ptr].right;
 
-            while (child_successor != nullptr) {
+            while (child_successor != no_node) {
                 parent_successor = successor;
                 successor = child_successor;
-                child_successor = child_successor->left;
+                child_successor = pool[child_successor].left;
             }
 
-            if (successor != ptr->right) {
-                parent_successor->left = successor->right;
+            if (successor != pool[ptr].right) {
+                pool[parent_successor].left = pool[successor].right;
             } else {
-                ptr->right = successor->right;
+                pool[ptr].right = pool[successor].right;
             }
 
-            ptr->value = successor->value;
-            delete successor;
+            pool[ptr].value = pool[successor].value;
+            pool.deallocate(successor);
         }
         --size;
     } catch (...) {
@@ -282,106 +643,315 @@ void BinarySearchTree<type>::remove(const type& value) {
 }
 
 template<typename type>
-void BinarySearchTree<type>::addOptimalTree(MatrixElement** matrix, const type* arr_value, int64_t i, int64_t j) {
-    if (matrix[i][j].r == -1 || matrix[i][j].r == 0 || find(arr_value[matrix[i][j].r - 1])) {
-        return;
-    } else {
-        type value = arr_value[matrix[i][j].r - 1];
-        
-        add(value);
-        addOptimalTree(matrix, arr_value, i, matrix[i][j].r - 1);
-        addOptimalTree(matrix, arr_value, matrix[i][j].r, j);
+void BinarySearchTree<type>::buildOptimalTree(const type* arr_value, const int64_t* successful_frequency, const int64_t& first_count, const int64_t* unsuccessful_frequency,
+                                              const int64_t& threads, const bool& access_order) {
+    clear();
+    try {
+        OptimalTable table(successful_frequency, first_count, unsuccessful_frequency);
+
+        table.compute(threads);
+        table.releaseCosts();
+        buildFromRoots(arr_value, first_count,
+                       [&table](const int64_t& i, const int64_t& j) { return table.getRoot(i, j); },
+                       [&table](const int64_t& i, const int64_t& j) { return table.weight(i, j); }, access_order);
+    } catch (...) {
+        std::cout << "\nBuild method threw except\n";
     }
 }
 
 template<typename type>
-void BinarySearchTree<type>::buildOptimalTree(const type* arr_value, const int64_t* successful_frequency, const int64_t& first_count, const int64_t* unsuccessful_frequency) {
-    clear();
-    size = first_count;
-
-    MatrixElement matrix_element;
-    MatrixElement** matrix = new MatrixElement*[size + 1];
-    for (int64_t i = 0; i < (size + 1); ++i) {
-        matrix[i] = new MatrixElement[size + 1];
+template<typename root_function, typename weight_function>
+void BinarySearchTree<type>::buildFromRoots(const type* arr_value, const int64_t& count, root_function root_of,
+                                            weight_function weight_of, const bool& access_order) {
+    struct Interval {
+        int64_t i;  // keys i + 1 .. j
+        int64_t j;
+        int64_t weight;  // chance that a search enters the interval, up to a factor
+        NodeIndex parent;  // node the root of the interval is hung from, no_node for the root
+        bool is_left;
+    };
+    auto lighter = [](const Interval& first, const Interval& second) {
+        return (first.weight != second.weight) ? (first.weight < second.weight) : (first.i > second.i);
+    };
+    std::vector<Interval> intervals;
+
+    if (count > 0) {
+        intervals.push_back({0, count, 0, no_node, false});
     }
 
-    for (int64_t i = 0; i < (size + 1); ++i) {
-       for (int64_t j = 0; j < (size + 1); ++j) {
-           matrix[i][j].w = -1;
-           matrix[i][j].r = -1;
-           matrix[i][j].p = -1;
-       }
-    }
+    // Every node is created once from its interval, with no search from the root. In access
+    // order the heaviest pending interval goes first, so the nodes come out of the pool sorted
+    // by how often a search passes them and the hot top of the tree shares cache lines.
+    // Otherwise the nodes are created depth first.
+    while (!intervals.empty()) {
+        if (access_order) {
+            std::pop_heap(intervals.begin(), intervals.end(), lighter);
+        }
+
+        Interval top = intervals.back();
+
+        intervals.pop_back();
+
+        int64_t r = root_of(top.i, top.j);
+        NodeIndex node = pool.allocate(arr_value[r - 1]);
 
-    for (int64_t i = 0; i < (size + 1); ++i) {
-        matrix_element.r = i;
-        matrix_element.p = 0;
-        matrix_element.w = unsuccessful_frequency[i];
-        matrix[i][i] = matrix_element;
+        if (top.parent == no_node) {
+            root = node;
+        } else if (top.is_left) {
+            pool[top.parent].left = node;
+        } else {
+            pool[top.parent].right = node;
+        }
+        ++size;
+        if (r < top.j) {
+            intervals.push_back({r, top.j, access_order ? weight_of(r, top.j) : 0, node, false});
+            if (access_order) {
+                std::push_heap(intervals.begin(), intervals.end(), lighter);
+            }
+        }
+        if (top.i < r - 1) {
+            intervals.push_back({top.i, r - 1, access_order ? weight_of(top.i, r - 1) : 0, node, true});
+            if (access_order) {
+                std::push_heap(intervals.begin(), intervals.end(), lighter);
+            }
+        }
     }
+}
 
-    for (int64_t l = 1; l < (size + 1); ++l) {
-        for (int64_t i = 0; i < (size - l + 1); ++i) {
-            std::multimap<int64_t, int64_t> map;
+template<typename type>
+void BinarySearchTree<type>::buildWeightBalancedTree(const type* arr_value, const int64_t* successful_frequency, const int64_t& first_count,
+                                                     const int64_t* unsuccessful_frequency) {
+    clear();
+    try {
+        if (first_count < 0) {
+            throw std::length_error("buildWeightBalancedTree");
+        }
 
-            int64_t j = i + l;
+        std::vector<int64_t> prefix(first_count + 1);  // as in OptimalTable, weight(i, j) = gap i + prefix[j] - prefix[i]
+
+        for (int64_t j = 1; j <= first_count; ++j) {
+            prefix[j] = prefix[j - 1] + successful_frequency[j - 1] + unsuccessful_frequency[j];
+        }
 
-            for (int64_t k = i + 1; k <= j; ++k) {
-                int64_t p = matrix[i][k - 1].p + matrix[k][j].p + matrix[i][k - 1].w + matrix[k][j].w;
-                map.insert({k, p});
+        // the weight left of root k minus the weight right of it, it grows with k
+        auto balance = [&](const int64_t& i, const int64_t& j, const int64_t& k) {
+            return (unsuccessful_frequency[i] + prefix[k - 1] - prefix[i]) -
+                   (unsuccessful_frequency[k] + prefix[j] - prefix[k]);
+        };
+
+        // Mehlhorn: the root is where the balance changes sign. It is searched
+        // with doubling steps from both ends at once, so a split costs the log of
+        // the smaller part and all splits together are O(n). The nodes are placed
+        // in access order, whose heap makes the whole build O(n log n).
+        buildFromRoots(arr_value, first_count, [&](const int64_t& i, const int64_t& j) {
+            int64_t low = i + 1;  // the first k with balance >= 0 is in [low, high], j if there is none
+            int64_t high = j;
+
+            for (int64_t step = 1; low < high; step *= 2) {
+                if (low + step - 1 >= high) {
+                    break;
+                }
+                if (balance(i, j, low + step - 1) >= 0) {
+                    high = low + step - 1;
+                    break;
+                }
+                low += step;
+                if (high - step < low) {
+                    break;
+                }
+                if (balance(i, j, high - step) < 0) {
+                    low = high - step + 1;
+                    break;
+                }
+                high -= step;
             }
+            while (low < high) {
+                int64_t middle = low + (high - low) / 2;
 
-            auto min = std::min_element(map.begin(), map.end(), [](const auto& a, const auto& b) {return a.second < b.second;});
-            matrix_element.r = min->first;
-            matrix_element.p = min->second;
-            matrix_element.w = matrix[i][j - 1].w + unsuccessful_frequency[j] + successful_frequency[j - 1];
+                if (balance(i, j, middle) >= 0) {
+                    high = middle;
+                } else {
+                    low = middle + 1;
+                }
+            }
+            if ((low > i + 1) && (std::abs(balance(i, j, low - 1)) <= std::abs(balance(i, j, low)))) {
+                --low;
+            }
+            return low;
+        }, [&](const int64_t& i, const int64_t& j) {
+            return unsuccessful_frequency[i] + prefix[j] - prefix[i];
+        }, true);
+    } catch (...) {
+        std::cout << "\nBuild method threw except\n";
+    }
+}
 
-            matrix[i][j] = matrix_element;
+template<typename type>
+std::vector<int64_t> BinarySearchTree<type>::alphabeticLevels(const int64_t* weights, const int64_t& count) {
+    std::vector<int64_t> parents(2 * count - 1, -1);
+    std::vector<int64_t> levels(2 * count - 1, 0);
+    WeightSequence sequence(count + 1);
+    std::vector<int64_t> pending;  // positions still to check, as distances from the end of sequence
+    int64_t next_id = count;
+
+    sequence.insert(0, std::numeric_limits<int64_t>::max(), -1);  // sentinel left of the items
+
+    // Phase 1: merge the leftmost pair (a, b) followed by c with a <= c (an infinite c after the
+    // last item), then move the merged item left past all smaller items. Every step reads,
+    // erases and inserts a constant number of items of the sequence, each in O(log n), and
+    // every item is merged once, so the phase takes O(n log n).
+    auto merge = [&](const int64_t& k) {  // merge the items at k - 1 and k, return the new position
+        int64_t weight = sequence.getWeight(k - 1) + sequence.getWeight(k);
+        int64_t id = next_id++;
+
+        parents[sequence.getId(k - 1)] = id;
+        parents[sequence.getId(k)] = id;
+        sequence.erase(k);
+        sequence.erase(k - 1);
+
+        int64_t position = sequence.lastAtLeast(k - 1, weight) + 1;
+
+        sequence.insert(position, weight, id);
+        return position;
+    };
+    auto settle = [&]() {  // merge until no pending position closes a pair
+        while (!pending.empty()) {
+            int64_t position = sequence.getSize() - 1 - pending.back();
+
+            if ((position >= 3) && (sequence.getWeight(position - 2) <= sequence.getWeight(position))) {
+                int64_t merged = merge(position - 1);
+
+                pending.push_back(sequence.getSize() - 1 - merged);
+            } else {
+                pending.pop_back();
+            }
         }
+    };
+
+    for (int64_t leaf = 0; leaf < count; ++leaf) {
+        sequence.insert(sequence.getSize(), weights[leaf], leaf);
+        pending.push_back(0);
+        settle();
+    }
+    while (sequence.getSize() > 2) {
+        int64_t position = merge(sequence.getSize() - 1);
+
+        pending.push_back(sequence.getSize() - 1 - position);
+        settle();
+    }
+    // Phase 2: depths of the leaves in the merge tree, a parent is created after its children
+    for (int64_t id = 2 * count - 3; id >= 0; --id) {
+        levels[id] = levels[parents[id]] + 1;
     }
+    levels.resize(count);
+    return levels;
+}
 
-    int64_t i = 0;
-    int64_t j = size;
-    type value = arr_value[matrix[i][j].r - 1];
+template<typename type>
+void BinarySearchTree<type>::buildAlphabeticTree(const type* arr_value, const int64_t* successful_frequency, const int64_t& first_count,
+                                                 const int64_t* unsuccessful_frequency) {
+    clear();
+    try {
+        if (first_count < 0) {
+            throw std::length_error("buildAlphabeticTree");
+        }
+        for (int64_t k = 0; k < first_count; ++k) {
+            if (successful_frequency[k] != 0) {  // only the gaps are weighted in the leaf-only case
+                throw std::invalid_argument("buildAlphabeticTree");
+            }
+        }
 
-//    for (int i = 0; i < size + 1; ++i) {
-//        for (int j = 0; j < size + 1; ++j) {
-//            std::cout << '"' << matrix[i][j].r << ' ' << matrix[i][j].w << ' ' << matrix[i][j].p << '"';
-//        }
-//        std::cout << '\n';
-//    }
+        struct Subtree {
+            int64_t level;
+            NodeIndex node;  // no_node for a gap
+            int64_t last;  // last gap of the subtree
+        };
+        std::vector<int64_t> levels = alphabeticLevels(unsuccessful_frequency, first_count + 1);
+        std::vector<Subtree> stack;
+
+        // Phase 3: the gaps keep their order and get the depths found above. Two neighbouring
+        // subtrees on one level become the children of the key between them.
+        for (int64_t gap = 0; gap <= first_count; ++gap) {
+            stack.push_back({levels[gap], no_node, gap});
+            while ((stack.size() >= 2) && (stack[stack.size() - 2].level == stack.back().level)) {
+                Subtree right = stack.back();
+
+                stack.pop_back();
+
+                Subtree left = stack.back();
+                NodeIndex node = pool.allocate(arr_value[left.last]);
+
+                stack.pop_back();
+                pool[node].left = left.node;
+                pool[node].right = right.node;
+                ++size;
+                stack.push_back({left.level - 1, node, right.last});
+            }
+        }
+        root = stack.front().node;
+    } catch (...) {
+        std::cout << "\nBuild method threw except\n";
+    }
+}
 
-    addOptimalTree(matrix, arr_value, i, j);
+template<typename type>
+int64_t BinarySearchTree<type>::getSearchCost(const int64_t* successful_frequency,
+                                              const int64_t* unsuccessful_frequency) const {
+    // a key costs its level (the root is 1), a gap the level of the missing child; keys and gaps are taken in order
+    std::vector<std::pair<NodeIndex, int64_t>> stack;
+    NodeIndex ptr = root;
+    int64_t level = 1;
+    int64_t key = 0;
+    int64_t cost = 0;
+
+    while (true) {
+        while (ptr != no_node) {
+            stack.push_back({ptr, level});
+            ptr = pool[ptr].left;
+            ++level;
+        }
+        cost += unsuccessful_frequency[key] * level;  // gap before the next key
+        if (stack.empty()) {
+            break;
+        }
+        ptr = stack.back().first;
+        level = stack.back().second;
+        stack.pop_back();
+        cost += successful_frequency[key++] * level;
+        ptr = pool[ptr].right;
+        ++level;
+    }
+    return cost;
 }
 
 template<typename type>
-void BinarySearchTree<type>::print_NLR(TreeNode<type> *node) const {
-    if (node == nullptr) {
+void BinarySearchTree<type>::print_NLR(const NodeIndex& node) const {
+    if (node == no_node) {
         return;
     }
-    std::cout << node->value << ' ';
-    print_NLR(node->left);
-    print_NLR(node->right);
+    std::cout << pool[node].value << ' ';
+    print_NLR(pool[node].left);
+    print_NLR(pool[node].right);
 }
 
 template<typename type>
-void BinarySearchTree<type>::print_LNR(TreeNode<type> *node) const {
-    if (node == nullptr) {
+void BinarySearchTree<type>::print_LNR(const NodeIndex& node) const {
+    if (node == no_node) {
         return;
     }
-    print_LNR(node->left);
-    std::cout << node->value << ' ';
-    print_LNR(node->right);
+    print_LNR(pool[node].left);
+    std::cout << pool[node].value << ' ';
+    print_LNR(pool[node].right);
 }
 
 template<typename type>
-void BinarySearchTree<type>::print_RNL(TreeNode<type> *node) const {
-    if (node == nullptr) {
+void BinarySearchTree<type>::print_RNL(const NodeIndex& node) const {
+    if (node == no_node) {
         return;
     }
-    print_RNL(node->right);
-    std::cout << node->value << ' ';
-    print_RNL(node->left);
+    print_RNL(pool[node].right);
+    std::cout << pool[node].value << ' ';
+    print_RNL(pool[node].left);
 }
 
 template<typename type>
@@ -401,7 +971,7 @@ void BinarySearchTree<type>::traversalRNL() const {
 
 template<typename type>
 bool BinarySearchTree<type>::isClear() const {
-    if (root == nullptr) {
+    if (root == no_node) {
         return true;
     }
     return false;
@@ -409,24 +979,47 @@ bool BinarySearchTree<type>::isClear() const {
 
 template<typename type>
 void BinarySearchTree<type>::clear() {
-    while (root != nullptr) {
-        remove(root->value);
+    destroy();
+}
+
+template<typename type>
+void BinarySearchTree<type>::destroy() {
+    if (!std::is_trivially_destructible<type>::value) {
+        NodeIndex ptr = root;
+
+        while (ptr != no_node) {  // rotate left children up, so every node is freed without a stack
+            if (pool[ptr].left != no_node) {
+                NodeIndex left = pool[ptr].left;
+
+                pool[ptr].left = pool[left].right;
+                pool[left].right = ptr;
+                ptr = left;
+            } else {
+                NodeIndex right = pool[ptr].right;
+
+                pool.deallocate(ptr);
+                ptr = right;
+            }
+        }
     }
+    pool.release();
+    root = no_node;
+    size = 0;
 }
 
 template<typename type>
-void BinarySearchTree<type>::print_tree(const TreeNode<type>* node,
+void BinarySearchTree<type>::print_tree(const NodeIndex& node,
                                         int tab, std::ostream& stream) const {
-    if (node == nullptr) {
+    if (node == no_node) {
         return;
     }
     tab += 1;
-    print_tree(node->right, tab, stream);
+    print_tree(pool[node].right, tab, stream);
     for (int64_t i = tab; i > 0; --i) {
         stream << "    ";
     }
-    stream << node->value << '\v';
-    print_tree(node->left, tab, stream);
+    stream << pool[node].value << '\v';
+    print_tree(pool[node].left, tab, stream);
 }
 
 template<typename type>
@@ -0,0 +1,472 @@
+// Copyright 2023 binoll
+#pragma once
+
+#include "../../libs.hpp"
+
+template<typename type>
+class RedBlackNode {
+ public:
+    RedBlackNode() = default;  // constructor without parameters
+
+    explicit RedBlackNode(const type& value);  // constructor with parameters
+
+    ~RedBlackNode() = default;  // destructor
+
+    type value = 0;  // value
+    bool red = true;  // color, new nodes are red
+    RedBlackNode<type>* left = nullptr;  // pointer to the left node
+    RedBlackNode<type>* right = nullptr;  // pointer to the right node
+    RedBlackNode<type>* parent = nullptr;  // pointer to the parent node
+};
+
+// Red-black tree: every path from a node down to a missing child has the same
+// number of black nodes and no red node has a red child, so the height stays
+// below 2 log2(n + 1). Balance is looser than in AVLSearchTree, and in
+// exchange an add does at most two rotations and a remove at most three;
+// the rest of the fixing is recoloring.
+template<typename type>
+class RedBlackTree {
+ public:
+    RedBlackTree() = default;  // constructor without parameters
+
+    explicit RedBlackTree(const type& value);  // constructor with parameters
+
+    RedBlackTree(const RedBlackTree<type>& tree) = delete;
+
+    RedBlackTree<type>& operator=(const RedBlackTree<type>& tree) = delete;
+
+    ~RedBlackTree();  // destructor
+
+    bool find(const type& value) const;  // searching for an element
+
+    type findMin() const;  // return min element
+
+    type findMax() const;  // return max element
+
+    void add(const type& value);  // add element
+
+    void remove(const type& value);  // delete element
+
+    void traversalNLR() const;  // tree traversal NRL
+
+    void traversalLNR() const;  // tree traversal LNR
+
+    void traversalRNL() const;  // tree traversal RNL
+
+    bool isClear() const;  // checking for emptiness
+
+    void clear();  // cleaning the tree
+
+    int64_t getSize() const;  // returns the current size of tree
+
+    template<typename new_type>
+    friend std::ostream& operator<<(std::ostream& stream,
+                                    const RedBlackTree<new_type>& tree);  // print
+
+ private:
+    static bool isRed(const RedBlackNode<type>* node);  // missing nodes are black
+
+    void leftRotate(RedBlackNode<type>* node);
+
+    void rightRotate(RedBlackNode<type>* node);
+
+    void transplant(RedBlackNode<type>* node, RedBlackNode<type>* child);  // put child in the place of node
+
+    void fixAdd(RedBlackNode<type>* node);  // repair a red node with a red parent
+
+    void fixRemove(RedBlackNode<type>* node, RedBlackNode<type>* parent);  // repair a missing black node
+
+    void print_NLR(RedBlackNode<type>* node) const;
+
+    void print_LNR(RedBlackNode<type>* node) const;
+
+    void print_RNL(RedBlackNode<type>* node) const;
+
+    void print_tree(const RedBlackNode<type>* node, int tab, std::ostream& stream) const;
+
+    void destroy();  // free all nodes in O(n) without recursion
+
+    RedBlackNode<type>* root = nullptr;  // pointer to the root of the tree
+    int64_t size = 0;  // current size of the tree
+};
+
+template<typename type>
+RedBlackNode<type>::RedBlackNode(const type& value) : value(value) {}
+
+template<typename type>
+RedBlackTree<type>::RedBlackTree(const type& value) {
+    try {
+        root = new RedBlackNode<type>(value);
+        root->red = false;
+        ++size;
+    } catch (...) {
+        std::cout << "\nConstruct threw except\n";
+    }
+}
+
+template<typename type>
+RedBlackTree<type>::~RedBlackTree() {
+    destroy();
+}
+
+template<typename type>
+bool RedBlackTree<type>::isRed(const RedBlackNode<type>* node) {
+    return (node != nullptr) && node->red;
+}
+
+template<typename type>
+bool RedBlackTree<type>::find(const type& value) const {
+    RedBlackNode<type>* ptr = root;
+
+    while (ptr != nullptr) {
+        if (ptr->value == value) {
+            return true;
+        } else if (ptr->value > value) {
+            ptr = ptr->left;
+        } else {
+            ptr = ptr->right;
+        }
+    }
+    return false;
+}
+
+template<typename type>
+type RedBlackTree<type>::findMin() const {
+    RedBlackNode<type>* ptr = root;
+
+    if (ptr == nullptr) {
+        return type();
+    }
+    while (ptr->left != nullptr) {
+        ptr = ptr->left;
+    }
+    return ptr->value;
+}
+
+template<typename type>
+type RedBlackTree<type>::findMax() const {
+    RedBlackNode<type>* ptr = root;
+
+    if (ptr == nullptr) {
+        return type();
+    }
+    while (ptr->right != nullptr) {
+        ptr = ptr->right;
+    }
+    return ptr->value;
+}
+
+template<typename type>
+void RedBlackTree<type>::leftRotate(RedBlackNode<type>* node) {
+    RedBlackNode<type>* right = node->right;
+
+    node->right = right->left;
+    if (right->left != nullptr) {
+        right->left->parent = node;
+    }
+    transplant(node, right);
+    right->left = node;
+    node->parent = right;
+}
+
+template<typename type>
+void RedBlackTree<type>::rightRotate(RedBlackNode<type>* node) {
+    RedBlackNode<type>* left = node->left;
+
+    node->left = left->right;
+    if (left->right != nullptr) {
+        left->right->parent = node;
+    }
+    transplant(node, left);
+    left->right = node;
+    node->parent = left;
+}
+
+template<typename type>
+void RedBlackTree<type>::transplant(RedBlackNode<type>* node, RedBlackNode<type>* child) {
+    if (node->parent == nullptr) {
+        root = child;
+    } else if (node == node->parent->left) {
+        node->parent->left = child;
+    } else {
+        node->parent->right = child;
+    }
+    if (child != nullptr) {
+        child->parent = node->parent;
+    }
+}
+
+template<typename type>
+void RedBlackTree<type>::add(const type& value) {
+    try {
+        RedBlackNode<type>* node = new RedBlackNode<type>(value);
+        RedBlackNode<type>* parent = nullptr;
+        RedBlackNode<type>* ptr = root;
+
+        while (ptr != nullptr) {
+            parent = ptr;
+            ptr = (ptr->value > value) ? ptr->left : ptr->right;
+        }
+        node->parent = parent;
+        if (parent == nullptr) {
+            root = node;
+        } else if (parent->value > value) {
+            parent->left = node;
+        } else {
+            parent->right = node;
+        }
+        ++size;
+        fixAdd(node);
+    } catch (...) {
+        std::cout << "\nAdd method threw except\n";
+    }
+}
+
+template<typename type>
+void RedBlackTree<type>::fixAdd(RedBlackNode<type>* node) {
+    while (isRed(node->parent)) {  // a red parent is never the root, so the grandparent exists
+        RedBlackNode<type>* parent = node->parent;
+        RedBlackNode<type>* grandparent = parent->parent;
+        bool is_left = (parent == grandparent->left);
+        RedBlackNode<type>* uncle = is_left ? grandparent->right : grandparent->left;
+
+        if (isRed(uncle)) {  // recolor and move the problem two levels up
+            parent->red = false;
+            uncle->red = false;
+            grandparent->red = true;
+            node = grandparent;
+            continue;
+        }
+        if (node == (is_left ? parent->right : parent->left)) {  // inner grandchild, turn it outer first
+            node = parent;
+            if (is_left) {
+                leftRotate(node);
+            } else {
+                rightRotate(node);
+            }
+            parent = node->parent;
+        }
+        parent->red = false;
+        grandparent->red = true;
+        if (is_left) {
+            rightRotate(grandparent);
+        } else {
+            leftRotate(grandparent);
+        }
+        break;
+    }
+    root->red = false;
+}
+
+template<typename type>
+void RedBlackTree<type>::remove(const type& value) {
+    RedBlackNode<type>* node = root;
+
+    while ((node != nullptr) && (node->value != value)) {  // search delete element
+        node = (node->value > value) ? node->left : node->right;
+    }
+    if (node == nullptr) {  // if did not search delete element
+        return;
+    }
+
+    RedBlackNode<type>* child = nullptr;  // node that moves into the vacated place
+    RedBlackNode<type>* parent = nullptr;  // parent of the vacated place
+    bool removed_red = node->red;  // color taken out of the tree
+
+    if (node->left == nullptr) {
+        child = node->right;
+        parent = node->parent;
+        transplant(node, node->right);
+    } else if (node->right == nullptr) {
+        child = node->left;
+        parent = node->parent;
+        transplant(node, node->left);
+    } else {  // the successor takes the place and the color of node
+        RedBlackNode<type>* successor = node->right;
+
+        while (successor->left != nullptr) {
+            successor = successor->left;
+        }
+        removed_red = successor->red;
+        child = successor->right;
+        if (successor->parent == node) {
+            parent = successor;
+        } else {
+            parent = successor->parent;
+            transplant(successor, successor->right);
+            successor->right = node->right;
+            successor->right->parent = successor;
+        }
+        transplant(node, successor);
+        successor->left = node->left;
+        successor->left->parent = successor;
+        successor->red = node->red;
+    }
+    delete node;
+    --size;
+    if (!removed_red) {
+        fixRemove(child, parent);
+    }
+}
+
+template<typename type>
+void RedBlackTree<type>::fixRemove(RedBlackNode<type>* node, RedBlackNode<type>* parent) {
+    while ((node != root) && !isRed(node)) {  // paths through node lack one black node
+        bool is_left = (node == parent->left);
+        RedBlackNode<type>* sibling = is_left ? parent->right : parent->left;
+
+        if (sibling->red) {  // make the sibling black
+            sibling->red = false;
+            parent->red = true;
+            if (is_left) {
+                leftRotate(parent);
+            } else {
+                rightRotate(parent);
+            }
+            sibling = is_left ? parent->right : parent->left;
+        }
+
+        RedBlackNode<type>* near = is_left ? sibling->left : sibling->right;
+        RedBlackNode<type>* far = is_left ? sibling->right : sibling->left;
+
+        if (!isRed(near) && !isRed(far)) {  // recolor and move the problem one level up
+            sibling->red = true;
+            node = parent;
+            parent = node->parent;
+            continue;
+        }
+        if (!isRed(far)) {  // turn the red child of the sibling outer first
+            near->red = false;
+            sibling->red = true;
+            if (is_left) {
+                rightRotate(sibling);
+            } else {
+                leftRotate(sibling);
+            }
+            sibling = is_left ? parent->right : parent->left;
+            far = is_left ? sibling->right : sibling->left;
+        }
+        sibling->red = parent->red;
+        parent->red = false;
+        far->red = false;
+        if (is_left) {
+            leftRotate(parent);
+        } else {
+            rightRotate(parent);
+        }
+        node = root;
+    }
+    if (node != nullptr) {
+        node->red = false;
+    }
+}
+
+template<typename type>
+void RedBlackTree<type>::print_NLR(RedBlackNode<type>* node) const {
+    if (node == nullptr) {
+        return;
+    }
+    std::cout << node->value << " ";
+    print_NLR(node->left);
+    print_NLR(node->right);
+}
+
+template<typename type>
+void RedBlackTree<type>::print_LNR(RedBlackNode<type>* node) const {
+    if (node == nullptr) {
+        return;
+    }
+    print_LNR(node->left);
+    std::cout << node->value << " ";
+    print_LNR(node->right);
+}
+
+template<typename type>
+void RedBlackTree<type>::print_RNL(RedBlackNode<type>* node) const {
+    if (node == nullptr) {
+        return;
+    }
+    print_RNL(node->right);
+    std::cout << node->value << " ";
+    print_RNL(node->left);
+}
+
+template<typename type>
+void RedBlackTree<type>::traversalNLR() const {
+    print_NLR(root);
+}
+
+template<typename type>
+void RedBlackTree<type>::traversalLNR() const {
+    print_LNR(root);
+}
+
+template<typename type>
+void RedBlackTree<type>::traversalRNL() const {
+    print_RNL(root);
+}
+
+template<typename type>
+bool RedBlackTree<type>::isClear() const {
+    return root == nullptr;
+}
+
+template<typename type>
+void RedBlackTree<type>::clear() {
+    destroy();
+}
+
+template<typename type>
+int64_t RedBlackTree<type>::getSize() const {
+    return size;
+}
+
+template<typename type>
+void RedBlackTree<type>::destroy() {
+    RedBlackNode<type>* ptr = root;
+
+    while (ptr != nullptr) {  // rotate left children up, so every node is freed without a stack
+        if (ptr->left != nullptr) {
+            RedBlackNode<type>* left = ptr->left;
+
+            ptr->left = left->right;
+            left->right = ptr;
+            ptr = left;
+        } else {
+            RedBlackNode<type>* right = ptr->right;
+
+            delete ptr;
+            ptr = right;
+        }
+    }
+    root = nullptr;
+    size = 0;
+}
+
+template<typename type>
+void RedBlackTree<type>::print_tree(const RedBlackNode<type>* node,
+                                    int tab, std::ostream& stream) const {
+    if (node == nullptr) {
+        return;
+    }
+    tab += 1;
+    print_tree(node->right, tab, stream);
+    for (int64_t i = tab; i > 0; --i) {
+        stream << "    ";
+    }
+    stream << node->value << (node->red ? "r" : "b") << '\v';
+    print_tree(node->left, tab, stream);
+}
+
+template<typename type>
+std::ostream& operator<<(std::ostream& stream,
+                         const RedBlackTree<type>& tree) {
+    if (tree.isClear()) {
+        stream << "Tree is clear!\n";
+    } else {
+        int tab = 0;
+
+        tree.print_tree(tree.root, tab, stream);
+    }
+    return stream;
+}
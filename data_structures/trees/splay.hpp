@@ -0,0 +1,437 @@
+// Copyright 2023 binoll
+#pragma once
+
+#include "../../libs.hpp"
+
+template<typename type>
+class SplayNode {
+ public:
+    SplayNode() = default;  // constructor without parameters
+
+    explicit SplayNode(const type& value);  // constructor with parameters
+
+    ~SplayNode() = default;  // destructor
+
+    type value = 0;  // value
+    SplayNode<type>* left = nullptr;  // pointer to the left node
+    SplayNode<type>* right = nullptr;  // pointer to the right node
+};
+
+// Splay tree (Sleator and Tarjan): every access moves the accessed node to the
+// root with top-down splaying, so recently and frequently used keys stay near
+// the top and a sequence of m operations costs O(m log n) amortized. This suits
+// skewed lookups whose hot keys drift over time, where optimal.hpp has to be
+// rebuilt from new frequencies. In semi-splay mode find only halves the depth
+// of the accessed path instead of moving the node to the root, which does less
+// restructuring per lookup and still lets hot keys migrate upward.
+template<typename type>
+class SplayTree {
+ public:
+    SplayTree() = default;  // constructor without parameters
+
+    explicit SplayTree(const type& value);  // constructor with parameters
+
+    SplayTree(const SplayTree<type>& tree) = delete;
+
+    SplayTree<type>& operator=(const SplayTree<type>& tree) = delete;
+
+    ~SplayTree();  // destructor
+
+    bool find(const type& value);  // searching for an element, restructures the tree
+
+    type findMin() const;  // return min element
+
+    type findMax() const;  // return max element
+
+    void add(const type& value);  // add element
+
+    void remove(const type& value);  // delete element
+
+    void setSemiSplay(const bool& enabled);  // semi-splay instead of splay on find
+
+    void traversalNLR() const;  // tree traversal NRL
+
+    void traversalLNR() const;  // tree traversal LNR
+
+    void traversalRNL() const;  // tree traversal RNL
+
+    bool isClear() const;  // checking for emptiness
+
+    void clear();  // cleaning the tree
+
+    int64_t getSize() const;  // returns the current size of tree
+
+    template<typename new_type>
+    friend std::ostream& operator<<(std::ostream& stream,
+                                    const SplayTree<new_type>& tree);  // print
+
+ private:
+    template<typename function>
+    static SplayNode<type>* splay(SplayNode<type>* node,
+                                  function direction);  // top-down splay, direction < 0 goes left, > 0 right
+
+    SplayNode<type>* splay(SplayNode<type>* node, const type& value);  // splay value or its neighbour
+
+    bool semiSplay(const type& value);  // search and halve the depth of the path
+
+    void print_NLR(SplayNode<type>* node) const;
+
+    void print_LNR(SplayNode<type>* node) const;
+
+    void print_RNL(SplayNode<type>* node) const;
+
+    void print_tree(const SplayNode<type>* node, int tab, std::ostream& stream) const;
+
+    void destroy();  // free all nodes in O(n) without recursion
+
+    SplayNode<type>* root = nullptr;  // pointer to the root of the tree
+    std::vector<SplayNode<type>*> path;  // search path of semiSplay, kept to reuse its memory
+    bool semi_splay = false;  // semi-splay on find
+    int64_t size = 0;  // current size of the tree
+};
+
+template<typename type>
+SplayNode<type>::SplayNode(const type& value) : value(value) {}
+
+template<typename type>
+SplayTree<type>::SplayTree(const type& value) {
+    try {
+        root = new SplayNode<type>(value);
+        ++size;
+    } catch (...) {
+        std::cout << "\nConstruct threw except\n";
+    }
+}
+
+template<typename type>
+SplayTree<type>::~SplayTree() {
+    destroy();
+}
+
+template<typename type>
+template<typename function>
+SplayNode<type>* SplayTree<type>::splay(SplayNode<type>* node, function direction) {
+    SplayNode<type>* left_root = nullptr;  // nodes less than the target, hung from the right
+    SplayNode<type>* right_root = nullptr;  // nodes greater than the target, hung from the left
+    SplayNode<type>** left_hook = &left_root;
+    SplayNode<type>** right_hook = &right_root;
+
+    if (node == nullptr) {
+        return nullptr;
+    }
+    while (true) {
+        int side = direction(node);
+
+        if (side < 0) {
+            if (node->left == nullptr) {
+                break;
+            }
+            if (direction(node->left) < 0) {  // zig-zig: rotate right first
+                SplayNode<type>* left = node->left;
+
+                node->left = left->right;
+                left->right = node;
+                node = left;
+                if (node->left == nullptr) {
+                    break;
+                }
+            }
+            *right_hook = node;
+            right_hook = &node->left;
+            node = node->left;
+        } else if (side > 0) {
+            if (node->right == nullptr) {
+                break;
+            }
+            if (direction(node->right) > 0) {  // zig-zig: rotate left first
+                SplayNode<type>* right = node->right;
+
+                node->right = right->left;
+                right->left = node;
+                node = right;
+                if (node->right == nullptr) {
+                    break;
+                }
+            }
+            *left_hook = node;
+            left_hook = &node->right;
+            node = node->right;
+        } else {
+            break;
+        }
+    }
+    *left_hook = node->left;
+    *right_hook = node->right;
+    node->left = left_root;
+    node->right = right_root;
+    return node;
+}
+
+template<typename type>
+SplayNode<type>* SplayTree<type>::splay(SplayNode<type>* node, const type& value) {
+    return splay(node, [&value](const SplayNode<type>* ptr) {
+        return (value < ptr->value) ? -1 : ((ptr->value < value) ? 1 : 0);
+    });
+}
+
+template<typename type>
+bool SplayTree<type>::semiSplay(const type& value) {
+    SplayNode<type>* ptr = root;
+    bool found = false;
+
+    path.clear();
+    while (ptr != nullptr) {
+        path.push_back(ptr);
+        if (value < ptr->value) {
+            ptr = ptr->left;
+        } else if (ptr->value < value) {
+            ptr = ptr->right;
+        } else {
+            found = true;
+            break;
+        }
+    }
+
+    int64_t index = static_cast<int64_t>(path.size()) - 1;  // current node, the last one visited first
+
+    while (index >= 2) {
+        SplayNode<type>* node = path[index];
+        SplayNode<type>* parent = path[index - 1];
+        SplayNode<type>* grandparent = path[index - 2];
+        SplayNode<type>* top = nullptr;  // new root of the subtree of grandparent
+
+        if ((parent == grandparent->left) == (node == parent->left)) {  // zig-zig: lift parent only
+            if (node == parent->left) {
+                grandparent->left = parent->right;
+                parent->right = grandparent;
+            } else {
+                grandparent->right = parent->left;
+                parent->left = grandparent;
+            }
+            top = parent;
+        } else {  // zig-zag: lift node over both, as in a splay
+            if (node == parent->left) {
+                parent->left = node->right;
+                grandparent->right = node->left;
+                node->right = parent;
+                node->left = grandparent;
+            } else {
+                parent->right = node->left;
+                grandparent->left = node->right;
+                node->left = parent;
+                node->right = grandparent;
+            }
+            top = node;
+        }
+        if (index == 2) {
+            root = top;
+        } else if (path[index - 3]->left == grandparent) {
+            path[index - 3]->left = top;
+        } else {
+            path[index - 3]->right = top;
+        }
+        path[index - 2] = top;
+        index -= 2;  // continue from the top of the restructured part
+    }
+    return found;
+}
+
+template<typename type>
+bool SplayTree<type>::find(const type& value) {
+    if (root == nullptr) {
+        return false;
+    }
+    if (semi_splay) {
+        return semiSplay(value);
+    }
+    root = splay(root, value);
+    return !(value < root->value) && !(root->value < value);
+}
+
+template<typename type>
+type SplayTree<type>::findMin() const {
+    SplayNode<type>* ptr = root;
+
+    if (ptr == nullptr) {
+        return type();
+    }
+    while (ptr->left != nullptr) {
+        ptr = ptr->left;
+    }
+    return ptr->value;
+}
+
+template<typename type>
+type SplayTree<type>::findMax() const {
+    SplayNode<type>* ptr = root;
+
+    if (ptr == nullptr) {
+        return type();
+    }
+    while (ptr->right != nullptr) {
+        ptr = ptr->right;
+    }
+    return ptr->value;
+}
+
+template<typename type>
+void SplayTree<type>::add(const type& value) {
+    try {
+        SplayNode<type>* node = new SplayNode<type>(value);
+
+        if (root != nullptr) {  // split the tree around value and put the new node on top
+            root = splay(root, value);
+            if (value < root->value) {
+                node->left = root->left;
+                node->right = root;
+                root->left = nullptr;
+            } else {
+                node->right = root->right;
+                node->left = root;
+                root->right = nullptr;
+            }
+        }
+        root = node;
+        ++size;
+    } catch (...) {
+        std::cout << "\nAdd method threw except\n";
+    }
+}
+
+template<typename type>
+void SplayTree<type>::remove(const type& value) {
+    if (root == nullptr) {
+        return;
+    }
+    root = splay(root, value);
+    if ((value < root->value) || (root->value < value)) {  // if did not search delete element
+        return;
+    }
+
+    SplayNode<type>* left = root->left;
+    SplayNode<type>* right = root->right;
+
+    delete root;
+    --size;
+    if (left == nullptr) {
+        root = right;
+    } else {  // the max of the left part has no right child, hang the right part there
+        root = splay(left, [](const SplayNode<type>*) { return 1; });
+        root->right = right;
+    }
+}
+
+template<typename type>
+void SplayTree<type>::setSemiSplay(const bool& enabled) {
+    semi_splay = enabled;
+}
+
+template<typename type>
+void SplayTree<type>::print_NLR(SplayNode<type>* node) const {
+    if (node == nullptr) {
+        return;
+    }
+    std::cout << node->value << " ";
+    print_NLR(node->left);
+    print_NLR(node->right);
+}
+
+template<typename type>
+void SplayTree<type>::print_LNR(SplayNode<type>* node) const {
+    if (node == nullptr) {
+        return;
+    }
+    print_LNR(node->left);
+    std::cout << node->value << " ";
+    print_LNR(node->right);
+}
+
+template<typename type>
+void SplayTree<type>::print_RNL(SplayNode<type>* node) const {
+    if (node == nullptr) {
+        return;
+    }
+    print_RNL(node->right);
+    std::cout << node->value << " ";
+    print_RNL(node->left);
+}
+
+template<typename type>
+void SplayTree<type>::traversalNLR() const {
+    print_NLR(root);
+}
+
+template<typename type>
+void SplayTree<type>::traversalLNR() const {
+    print_LNR(root);
+}
+
+template<typename type>
+void SplayTree<type>::traversalRNL() const {
+    print_RNL(root);
+}
+
+template<typename type>
+bool SplayTree<type>::isClear() const {
+    return root == nullptr;
+}
+
+template<typename type>
+void SplayTree<type>::clear() {
+    destroy();
+}
+
+template<typename type>
+int64_t SplayTree<type>::getSize() const {
+    return size;
+}
+
+template<typename type>
+void SplayTree<type>::destroy() {
+    SplayNode<type>* ptr = root;
+
+    while (ptr != nullptr) {  // rotate left children up, so every node is freed without a stack
+        if (ptr->left != nullptr) {
+            SplayNode<type>* left = ptr->left;
+
+            ptr->left = left->right;
+            left->right = ptr;
+            ptr = left;
+        } else {
+            SplayNode<type>* right = ptr->right;
+
+            delete ptr;
+            ptr = right;
+        }
+    }
+    root = nullptr;
+    size = 0;
+}
+
+template<typename type>
+void SplayTree<type>::print_tree(const SplayNode<type>* node,
+                                 int tab, std::ostream& stream) const {
+    if (node == nullptr) {
+        return;
+    }
+    tab += 1;
+    print_tree(node->right, tab, stream);
+    for (int64_t i = tab; i > 0; --i) {
+        stream << "    ";
+    }
+    stream << node->value << '\v';
+    print_tree(node->left, tab, stream);
+}
+
+template<typename type>
+std::ostream& operator<<(std::ostream& stream,
+                         const SplayTree<type>& tree) {
+    if (tree.isClear()) {
+        stream << "Tree is clear!\n";
+    } else {
+        int tab = 0;
+
+        tree.print_tree(tree.root, tab, stream);
+    }
+    return stream;
+}
@@ -0,0 +1,476 @@
+// Copyright 2023 binoll
+#pragma once
+
+#include "../../libs.hpp"
+
+template<typename type>
+class WAVLNode {
+ public:
+    WAVLNode() = default;  // constructor without parameters
+
+    explicit WAVLNode(const type& value);  // constructor with parameters
+
+    ~WAVLNode() = default;  // destructor
+
+    type value = 0;  // value
+    int8_t rank = 0;  // rank, leaves have rank 0 and missing nodes rank -1
+    WAVLNode<type>* left = nullptr;  // pointer to the left node
+    WAVLNode<type>* right = nullptr;  // pointer to the right node
+    WAVLNode<type>* parent = nullptr;  // pointer to the parent node
+};
+
+// Weak AVL tree (Haeupler, Sen and Tarjan): every node keeps a rank, the rank
+// of a parent exceeds the rank of each child by 1 or 2 and every leaf has
+// rank 0. With adds only it is exactly an AVL tree; a remove fixes the ranks
+// by demotions and then does at most two rotations, where AVLSearchTree can
+// rotate at every level. The height stays below 2 log2(n + 1).
+template<typename type>
+class WAVLTree {
+ public:
+    WAVLTree() = default;  // constructor without parameters
+
+    explicit WAVLTree(const type& value);  // constructor with parameters
+
+    WAVLTree(const WAVLTree<type>& tree) = delete;
+
+    WAVLTree<type>& operator=(const WAVLTree<type>& tree) = delete;
+
+    ~WAVLTree();  // destructor
+
+    bool find(const type& value) const;  // searching for an element
+
+    type findMin() const;  // return min element
+
+    type findMax() const;  // return max element
+
+    void add(const type& value);  // add element
+
+    void remove(const type& value);  // delete element
+
+    void traversalNLR() const;  // tree traversal NRL
+
+    void traversalLNR() const;  // tree traversal LNR
+
+    void traversalRNL() const;  // tree traversal RNL
+
+    bool isClear() const;  // checking for emptiness
+
+    void clear();  // cleaning the tree
+
+    int64_t getSize() const;  // returns the current size of tree
+
+    template<typename new_type>
+    friend std::ostream& operator<<(std::ostream& stream,
+                                    const WAVLTree<new_type>& tree);  // print
+
+ private:
+    static int64_t rankOf(const WAVLNode<type>* node);  // -1 for missing nodes
+
+    void leftRotate(WAVLNode<type>* node);
+
+    void rightRotate(WAVLNode<type>* node);
+
+    void transplant(WAVLNode<type>* node, WAVLNode<type>* child);  // put child in the place of node
+
+    void fixAdd(WAVLNode<type>* node);  // repair a node with the rank of its parent
+
+    void fixRemove(WAVLNode<type>* node, WAVLNode<type>* parent,
+                   bool is_left);  // repair a leaf of rank 1 or a child 3 ranks below parent
+
+    void print_NLR(WAVLNode<type>* node) const;
+
+    void print_LNR(WAVLNode<type>* node) const;
+
+    void print_RNL(WAVLNode<type>* node) const;
+
+    void print_tree(const WAVLNode<type>* node, int tab, std::ostream& stream) const;
+
+    void destroy();  // free all nodes in O(n) without recursion
+
+    WAVLNode<type>* root = nullptr;  // pointer to the root of the tree
+    int64_t size = 0;  // current size of the tree
+};
+
+template<typename type>
+WAVLNode<type>::WAVLNode(const type& value) : value(value) {}
+
+template<typename type>
+WAVLTree<type>::WAVLTree(const type& value) {
+    try {
+        root = new WAVLNode<type>(value);
+        ++size;
+    } catch (...) {
+        std::cout << "\nConstruct threw except\n";
+    }
+}
+
+template<typename type>
+WAVLTree<type>::~WAVLTree() {
+    destroy();
+}
+
+template<typename type>
+int64_t WAVLTree<type>::rankOf(const WAVLNode<type>* node) {
+    return (node == nullptr) ? -1 : node->rank;
+}
+
+template<typename type>
+bool WAVLTree<type>::find(const type& value) const {
+    WAVLNode<type>* ptr = root;
+
+    while (ptr != nullptr) {
+        if (ptr->value == value) {
+            return true;
+        } else if (ptr->value > value) {
+            ptr = ptr->left;
+        } else {
+            ptr = ptr->right;
+        }
+    }
+    return false;
+}
+
+template<typename type>
+type WAVLTree<type>::findMin() const {
+    WAVLNode<type>* ptr = root;
+
+    if (ptr == nullptr) {
+        return type();
+    }
+    while (ptr->left != nullptr) {
+        ptr = ptr->left;
+    }
+    return ptr->value;
+}
+
+template<typename type>
+type WAVLTree<type>::findMax() const {
+    WAVLNode<type>* ptr = root;
+
+    if (ptr == nullptr) {
+        return type();
+    }
+    while (ptr->right != nullptr) {
+        ptr = ptr->right;
+    }
+    return ptr->value;
+}
+
+template<typename type>
+void WAVLTree<type>::leftRotate(WAVLNode<type>* node) {
+    WAVLNode<type>* right = node->right;
+
+    node->right = right->left;
+    if (right->left != nullptr) {
+        right->left->parent = node;
+    }
+    transplant(node, right);
+    right->left = node;
+    node->parent = right;
+}
+
+template<typename type>
+void WAVLTree<type>::rightRotate(WAVLNode<type>* node) {
+    WAVLNode<type>* left = node->left;
+
+    node->left = left->right;
+    if (left->right != nullptr) {
+        left->right->parent = node;
+    }
+    transplant(node, left);
+    left->right = node;
+    node->parent = left;
+}
+
+template<typename type>
+void WAVLTree<type>::transplant(WAVLNode<type>* node, WAVLNode<type>* child) {
+    if (node->parent == nullptr) {
+        root = child;
+    } else if (node == node->parent->left) {
+        node->parent->left = child;
+    } else {
+        node->parent->right = child;
+    }
+    if (child != nullptr) {
+        child->parent = node->parent;
+    }
+}
+
+template<typename type>
+void WAVLTree<type>::add(const type& value) {
+    try {
+        WAVLNode<type>* node = new WAVLNode<type>(value);
+        WAVLNode<type>* parent = nullptr;
+        WAVLNode<type>* ptr = root;
+
+        while (ptr != nullptr) {
+            parent = ptr;
+            ptr = (ptr->value > value) ? ptr->left : ptr->right;
+        }
+        node->parent = parent;
+        if (parent == nullptr) {
+            root = node;
+        } else if (parent->value > value) {
+            parent->left = node;
+        } else {
+            parent->right = node;
+        }
+        ++size;
+        fixAdd(node);
+    } catch (...) {
+        std::cout << "\nAdd method threw except\n";
+    }
+}
+
+template<typename type>
+void WAVLTree<type>::fixAdd(WAVLNode<type>* node) {
+    WAVLNode<type>* parent = node->parent;
+
+    while ((parent != nullptr) && (parent->rank == node->rank)) {
+        bool is_left = (node == parent->left);
+        WAVLNode<type>* sibling = is_left ? parent->right : parent->left;
+
+        if (parent->rank - rankOf(sibling) == 1) {  // promote and move the problem one level up
+            ++parent->rank;
+            node = parent;
+            parent = node->parent;
+            continue;
+        }
+
+        WAVLNode<type>* inner = is_left ? node->right : node->left;
+
+        if (node->rank - rankOf(inner) == 2) {  // single rotation
+            if (is_left) {
+                rightRotate(parent);
+            } else {
+                leftRotate(parent);
+            }
+            --parent->rank;
+        } else {  // double rotation, inner goes to the top
+            if (is_left) {
+                leftRotate(node);
+                rightRotate(parent);
+            } else {
+                rightRotate(node);
+                leftRotate(parent);
+            }
+            ++inner->rank;
+            --node->rank;
+            --parent->rank;
+        }
+        break;
+    }
+}
+
+template<typename type>
+void WAVLTree<type>::remove(const type& value) {
+    WAVLNode<type>* node = root;
+
+    while ((node != nullptr) && (node->value != value)) {  // search delete element
+        node = (node->value > value) ? node->left : node->right;
+    }
+    if (node == nullptr) {  // if did not search delete element
+        return;
+    }
+
+    WAVLNode<type>* child = nullptr;  // node that moves into the vacated place
+    WAVLNode<type>* parent = node->parent;  // parent of the vacated place
+    bool is_left = (parent != nullptr) && (node == parent->left);  // side of the vacated place
+
+    if (node->left == nullptr) {
+        child = node->right;
+        transplant(node, node->right);
+    } else if (node->right == nullptr) {
+        child = node->left;
+        transplant(node, node->left);
+    } else {  // the successor takes the place and the rank of node
+        WAVLNode<type>* successor = node->right;
+
+        while (successor->left != nullptr) {
+            successor = successor->left;
+        }
+        child = successor->right;
+        if (successor->parent == node) {
+            parent = successor;
+            is_left = false;
+        } else {
+            parent = successor->parent;
+            is_left = true;
+            transplant(successor, successor->right);
+            successor->right = node->right;
+            successor->right->parent = successor;
+        }
+        transplant(node, successor);
+        successor->left = node->left;
+        successor->left->parent = successor;
+        successor->rank = node->rank;
+    }
+    delete node;
+    --size;
+    fixRemove(child, parent, is_left);
+}
+
+template<typename type>
+void WAVLTree<type>::fixRemove(WAVLNode<type>* node, WAVLNode<type>* parent, bool is_left) {
+    if (parent == nullptr) {
+        return;
+    }
+    if ((parent->rank == 1) && (parent->left == nullptr) && (parent->right == nullptr)) {  // leaf of rank 1
+        --parent->rank;
+        node = parent;
+        parent = node->parent;
+        is_left = (parent != nullptr) && (node == parent->left);
+    }
+    while ((parent != nullptr) && (parent->rank - rankOf(node) == 3)) {
+        WAVLNode<type>* sibling = is_left ? parent->right : parent->left;  // exists, its rank is at least 0
+
+        if (parent->rank - sibling->rank == 2) {  // demote and move the problem one level up
+            --parent->rank;
+        } else if ((sibling->rank - rankOf(sibling->left) == 2) &&
+                   (sibling->rank - rankOf(sibling->right) == 2)) {  // demote both
+            --parent->rank;
+            --sibling->rank;
+        } else {
+            WAVLNode<type>* far = is_left ? sibling->right : sibling->left;
+            WAVLNode<type>* near = is_left ? sibling->left : sibling->right;
+
+            if (sibling->rank - rankOf(far) == 1) {  // single rotation
+                if (is_left) {
+                    leftRotate(parent);
+                } else {
+                    rightRotate(parent);
+                }
+                ++sibling->rank;
+                --parent->rank;
+                if ((parent->left == nullptr) && (parent->right == nullptr)) {  // leaves have rank 0
+                    --parent->rank;
+                }
+            } else {  // double rotation, near goes to the top
+                if (is_left) {
+                    rightRotate(sibling);
+                    leftRotate(parent);
+                } else {
+                    leftRotate(sibling);
+                    rightRotate(parent);
+                }
+                near->rank += 2;
+                --sibling->rank;
+                parent->rank -= 2;
+            }
+            return;
+        }
+        node = parent;
+        parent = node->parent;
+        is_left = (parent != nullptr) && (node == parent->left);
+    }
+}
+
+template<typename type>
+void WAVLTree<type>::print_NLR(WAVLNode<type>* node) const {
+    if (node == nullptr) {
+        return;
+    }
+    std::cout << node->value << " ";
+    print_NLR(node->left);
+    print_NLR(node->right);
+}
+
+template<typename type>
+void WAVLTree<type>::print_LNR(WAVLNode<type>* node) const {
+    if (node == nullptr) {
+        return;
+    }
+    print_LNR(node->left);
+    std::cout << node->value << " ";
+    print_LNR(node->right);
+}
+
+template<typename type>
+void WAVLTree<type>::print_RNL(WAVLNode<type>* node) const {
+    if (node == nullptr) {
+        return;
+    }
+    print_RNL(node->right);
+    std::cout << node->value << " ";
+    print_RNL(node->left);
+}
+
+template<typename type>
+void WAVLTree<type>::traversalNLR() const {
+    print_NLR(root);
+}
+
+template<typename type>
+void WAVLTree<type>::traversalLNR() const {
+    print_LNR(root);
+}
+
+template<typename type>
+void WAVLTree<type>::traversalRNL() const {
+    print_RNL(root);
+}
+
+template<typename type>
+bool WAVLTree<type>::isClear() const {
+    return root == nullptr;
+}
+
+template<typename type>
+void WAVLTree<type>::clear() {
+    destroy();
+}
+
+template<typename type>
+int64_t WAVLTree<type>::getSize() const {
+    return size;
+}
+
+template<typename type>
+void WAVLTree<type>::destroy() {
+    WAVLNode<type>* ptr = root;
+
+    while (ptr != nullptr) {  // rotate left children up, so every node is freed without a stack
+        if (ptr->left != nullptr) {
+            WAVLNode<type>* left = ptr->left;
+
+            ptr->left = left->right;
+            left->right = ptr;
+            ptr = left;
+        } else {
+            WAVLNode<type>* right = ptr->right;
+
+            delete ptr;
+            ptr = right;
+        }
+    }
+    root = nullptr;
+    size = 0;
+}
+
+template<typename type>
+void WAVLTree<type>::print_tree(const WAVLNode<type>* node,
+                                int tab, std::ostream& stream) const {
+    if (node == nullptr) {
+        return;
+    }
+    tab += 1;
+    print_tree(node->right, tab, stream);
+    for (int64_t i = tab; i > 0; --i) {
+        stream << "    ";
+    }
+    stream << node->value << '\v';
+    print_tree(node->left, tab, stream);
+}
+
+template<typename type>
+std::ostream& operator<<(std::ostream& stream,
+                         const WAVLTree<type>& tree) {
+    if (tree.isClear()) {
+        stream << "Tree is clear!\n";
+    } else {
+        int tab = 0;
+
+        tree.print_tree(tree.root, tab, stream);
+    }
+    return stream;
+}